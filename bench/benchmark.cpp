@@ -0,0 +1,107 @@
+/*
+    Copyright 2021 natinusala
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <chrono>
+
+#include "benchmark.hpp"
+
+BenchmarkSuite::BenchmarkSuite(std::string filter)
+    : filter(filter)
+{
+}
+
+void BenchmarkSuite::run(std::string name, unsigned iterations, std::function<void()> body)
+{
+    this->run(
+        name, iterations, [] {}, body, [] {});
+}
+
+void BenchmarkSuite::run(std::string name, unsigned iterations, std::function<void()> setup, std::function<void()> body, std::function<void()> teardown)
+{
+    if (!this->filter.empty() && name.find(this->filter) == std::string::npos)
+        return;
+
+    // Warm up
+    setup();
+    body();
+    teardown();
+
+    std::vector<double> timings;
+    timings.reserve(iterations);
+
+    for (unsigned i = 0; i < iterations; i++)
+    {
+        setup();
+
+        auto start = std::chrono::steady_clock::now();
+        body();
+        auto end = std::chrono::steady_clock::now();
+
+        teardown();
+
+        timings.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+    }
+
+    std::sort(timings.begin(), timings.end());
+
+    double total = 0.0;
+    for (double timing : timings)
+        total += timing;
+
+    BenchmarkResult result;
+    result.name       = name;
+    result.iterations = iterations;
+    result.mean       = total / iterations;
+    result.median     = timings[iterations / 2];
+    result.min        = timings.front();
+    result.max        = timings.back();
+
+    fmt::print(stderr, "{:<40} {:>12.2f}us (median {:.2f}us, {} iterations)\n", name, result.mean, result.median, iterations);
+
+    this->results.push_back(result);
+}
+
+const std::vector<BenchmarkResult>& BenchmarkSuite::getResults()
+{
+    return this->results;
+}
+
+std::string BenchmarkSuite::toJSON(std::string platform)
+{
+    std::string json = fmt::format("{{\n  \"platform\": \"{}\",\n  \"benchmarks\": [", platform);
+
+    for (size_t i = 0; i < this->results.size(); i++)
+    {
+        const BenchmarkResult& result = this->results[i];
+
+        json += fmt::format(
+            "{}\n    {{ \"name\": \"{}\", \"iterations\": {}, \"mean_us\": {:.3f}, \"median_us\": {:.3f}, \"min_us\": {:.3f}, \"max_us\": {:.3f} }}",
+            i == 0 ? "" : ",",
+            result.name,
+            result.iterations,
+            result.mean,
+            result.median,
+            result.min,
+            result.max);
+    }
+
+    json += "\n  ]\n}\n";
+    return json;
+}
@@ -0,0 +1,67 @@
+/*
+    Copyright 2021 natinusala
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+// Timings of one benchmark, in µs per iteration
+struct BenchmarkResult
+{
+    std::string name;
+    unsigned iterations;
+
+    double mean;
+    double median;
+    double min;
+    double max;
+};
+
+// Runs benchmarks and collects their timings. Each benchmark runs once
+// untimed to warm up, then the given amount of timed iterations.
+class BenchmarkSuite
+{
+  public:
+    /**
+     * Only the benchmarks whose name contains the filter run (all of them if empty).
+     */
+    BenchmarkSuite(std::string filter);
+
+    /**
+     * Runs a benchmark, timing each call of the body.
+     */
+    void run(std::string name, unsigned iterations, std::function<void()> body);
+
+    /**
+     * Runs a benchmark, timing each call of the body only:
+     * setup and teardown run before and after every iteration.
+     */
+    void run(std::string name, unsigned iterations, std::function<void()> setup, std::function<void()> body, std::function<void()> teardown);
+
+    const std::vector<BenchmarkResult>& getResults();
+
+    /**
+     * Returns the results as a JSON document, to be compared between releases.
+     */
+    std::string toJSON(std::string platform);
+
+  private:
+    std::string filter;
+    std::vector<BenchmarkResult> results;
+};
@@ -0,0 +1,368 @@
+/*
+    Copyright 2021 natinusala
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+// Micro-benchmarks of borealis, running on the headless platform (no window).
+// Usage: borealis_bench [--output <file.json>] [--filter <name>]
+// The results are printed as JSON on stdout, or written to the given file.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <yoga/YGNode.h>
+
+#include <borealis.hpp>
+#include <cmath>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "captioned_image.hpp"
+#include "components_tab.hpp"
+#include "recycling_list_tab.hpp"
+#include "storage_file_demo.hpp"
+
+using namespace brls::literals; // for _i18n
+
+static const std::string SHORT_TEXT = "Lorem ipsum";
+static const std::string LONG_TEXT  = "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor incididunt ut labore et dolore magna aliqua. "
+                                     "Ut enim ad minim veniam, quis nostrud exercitation ullamco laboris nisi ut aliquip ex ea commodo consequat. "
+                                     "Duis aute irure dolor in reprehenderit in voluptate velit esse cillum dolore eu fugiat nulla pariatur.";
+
+struct BenchSettingsFile : public brls::StorageFile
+{
+    BRLS_STORAGE_FILE_INIT(BenchSettingsFile, "settings", "borealis_bench")
+
+    BRLS_STORAGE_INT(counter, "counter");
+    BRLS_STORAGE_STRING(username, "username");
+    BRLS_STORAGE_INT_LIST(numbers, "numbers");
+};
+
+static void benchViewsCreation(BenchmarkSuite* suite)
+{
+    suite->run("create/labels_1000", 20, [] {
+        brls::Box* box = new brls::Box();
+
+        for (int i = 0; i < 1000; i++)
+        {
+            brls::Label* label = new brls::Label();
+            label->setText(SHORT_TEXT);
+            box->addView(label);
+        }
+
+        delete box;
+    });
+
+    suite->run("create/boxes_1000", 20, [] {
+        brls::Box* box = new brls::Box();
+
+        for (int i = 0; i < 1000; i++)
+            box->addView(new brls::Box());
+
+        delete box;
+    });
+}
+
+static void benchXMLInflation(BenchmarkSuite* suite)
+{
+    std::vector<std::filesystem::path> files;
+
+    for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(brls::BRLS_ASSET("xml")))
+    {
+        if (entry.is_regular_file() && entry.path().extension() == ".xml")
+            files.push_back(entry.path());
+    }
+
+    std::sort(files.begin(), files.end());
+
+    for (const std::filesystem::path& file : files)
+    {
+        std::string name = std::filesystem::relative(file, brls::BRLS_ASSET("xml")).generic_string();
+        std::string path = file.string();
+
+        suite->run("inflate/" + name, 20, [path] {
+            delete brls::View::createFromXMLFile(path);
+        });
+    }
+}
+
+static void benchInvalidate(BenchmarkSuite* suite)
+{
+    brls::Box* deep = nullptr;
+    brls::Box* wide = nullptr;
+    bool toggle     = false;
+
+    // Deep tree: a chain of 200 boxes with a label at the bottom
+    suite->run(
+        "invalidate/deep_200", 100,
+        [&] {
+            deep = new brls::Box(brls::Axis::COLUMN);
+
+            brls::Box* parent = deep;
+            for (int i = 0; i < 200; i++)
+            {
+                brls::Box* box = new brls::Box(brls::Axis::COLUMN);
+                box->setPadding(1, 1, 1, 1);
+                parent->addView(box);
+                parent = box;
+            }
+
+            brls::Label* label = new brls::Label();
+            label->setText(SHORT_TEXT);
+            parent->addView(label);
+        },
+        [&] {
+            // Changing the root size invalidates the layout of the whole tree
+            toggle = !toggle;
+            deep->setWidth(toggle ? 1280.0f : 1279.0f);
+        },
+        [&] { delete deep; });
+
+    // Wide tree: 1000 labels in a single box
+    suite->run(
+        "invalidate/wide_1000", 100,
+        [&] {
+            wide = new brls::Box(brls::Axis::COLUMN);
+
+            for (int i = 0; i < 1000; i++)
+            {
+                brls::Label* label = new brls::Label();
+                label->setText(SHORT_TEXT);
+                wide->addView(label);
+            }
+        },
+        [&] {
+            toggle = !toggle;
+            wide->setWidth(toggle ? 1280.0f : 1279.0f);
+        },
+        [&] { delete wide; });
+}
+
+static void benchThemeLookups(BenchmarkSuite* suite)
+{
+    suite->run("theme/get_color_1000", 100, [] {
+        brls::Theme& theme = brls::Application::getTheme();
+        float total        = 0.0f;
+
+        for (int i = 0; i < 1000; i++)
+            total += theme.getColor("brls/text", brls::ThemeVariant::LIGHT).r;
+
+        volatile float sink = total;
+        (void)sink;
+    });
+
+    suite->run("style/lookup_1000", 100, [] {
+        brls::Style style = brls::Application::getStyle();
+        float total       = 0.0f;
+
+        for (int i = 0; i < 1000; i++)
+            total += style["brls/highlight/stroke_width"];
+
+        volatile float sink = total;
+        (void)sink;
+    });
+}
+
+static void benchLabelMeasure(BenchmarkSuite* suite)
+{
+    brls::Label* label = new brls::Label();
+
+    for (auto [name, text] : { std::make_pair("short", SHORT_TEXT), std::make_pair("long", LONG_TEXT) })
+    {
+        label->setText(text);
+
+        // Calls labelMeasureFunc directly through the Yoga node
+        suite->run(std::string("label/measure_") + name + "_100", 100, [label] {
+            YGNode* node = label->getYGNode();
+
+            for (int i = 0; i < 100; i++)
+                node->measure(640.0f, YGMeasureModeAtMost, NAN, YGMeasureModeUndefined, nullptr);
+        });
+    }
+
+    delete label;
+}
+
+static void benchTickings(BenchmarkSuite* suite)
+{
+    std::vector<brls::Animatable*> animatables;
+
+    suite->run(
+        "ticking/update_1000_animations", 100,
+        [&] {
+            for (int i = 0; i < 1000; i++)
+            {
+                brls::Animatable* animatable = new brls::Animatable(0.0f);
+                animatable->addStep(1.0f, 1000000, brls::EasingFunction::quadraticOut);
+                animatable->start();
+                animatables.push_back(animatable);
+            }
+        },
+        [] { brls::Ticking::updateTickings(16.666f); },
+        [&] {
+            for (brls::Animatable* animatable : animatables)
+                delete animatable;
+
+            animatables.clear();
+        });
+}
+
+static void benchNavigation(BenchmarkSuite* suite)
+{
+    for (bool spatial : { false, true })
+    {
+        brls::Box* box = new brls::Box(brls::Axis::ROW);
+        box->setSpatialNavigationEnabled(spatial);
+
+        std::vector<brls::View*> children;
+        for (int i = 0; i < 1000; i++)
+        {
+            brls::Rectangle* rectangle = new brls::Rectangle();
+            rectangle->setDimensions(10.0f, 10.0f);
+            rectangle->setFocusable(true);
+            box->addView(rectangle);
+            children.push_back(rectangle);
+        }
+
+        box->invalidate();
+
+        suite->run(std::string("navigation/next_focus_1000") + (spatial ? "_spatial" : ""), 100, [box, &children] {
+            for (brls::View* child : children)
+                box->getNextFocus(brls::FocusDirection::RIGHT, child);
+        });
+
+        delete box;
+    }
+}
+
+static void benchStorageFile(BenchmarkSuite* suite)
+{
+    BenchSettingsFile* settings = new BenchSettingsFile();
+
+    suite->run("storage/save", 50, [settings] {
+        settings->numbers.getVector().clear();
+
+        settings->counter  = 42;
+        settings->username = "borealis";
+
+        for (int i = 0; i < 100; i++)
+            settings->numbers.pushValue(i);
+
+        settings->counter.save();
+        settings->username.save();
+        settings->numbers.save();
+    });
+
+    delete settings;
+
+    suite->run("storage/load", 50, [] {
+        BenchSettingsFile file;
+
+        file.readFromFile("counter", file.counter);
+        file.readFromFile("username", file.username);
+        file.readFromFile("numbers", file.numbers);
+    });
+}
+
+int main(int argc, char* argv[])
+{
+    std::string output;
+    std::string filter;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+
+        if (arg == "--output" && i + 1 < argc)
+            output = argv[++i];
+        else if (arg == "--filter" && i + 1 < argc)
+            filter = argv[++i];
+    }
+
+    // Keep stdout for the results
+    brls::Logger::setLogLevel(brls::LogLevel::ERROR);
+
+    if (!brls::Application::init())
+    {
+        brls::Logger::error("Unable to init Borealis application");
+        return EXIT_FAILURE;
+    }
+
+    brls::Application::createWindow("borealis_bench");
+
+    // Same setup as the demo, for its XML files
+    brls::Application::registerXMLView("CaptionedImage", CaptionedImage::create);
+    brls::Application::registerXMLView("RecyclingListTab", RecyclingListTab::create);
+    brls::Application::registerXMLView("ComponentsTab", ComponentsTab::create);
+    brls::Application::registerXMLView("StorageFileDemo", StorageFileDemo::create);
+
+    brls::Application::getTheme().inflateFromXMLString(R"xml(
+        <brls:Stylesheet theme="brls/default" prefix="captioned_image">
+            <brls:ThemeVariant name="light">
+                <brls:Color name="caption" value="rgb(2,176,183)"/>
+            </brls:ThemeVariant>
+
+            <brls:ThemeVariant name="dark">
+                <brls:Color name="caption" value="rgb(51,186,227)"/>
+            </brls:ThemeVariant>
+        </brls:Stylesheet>
+    )xml");
+
+    brls::Application::getTheme().inflateFromXMLString(R"xml(
+        <brls:Stylesheet theme="brls/default" prefix="about">
+            <brls:Metric name="padding_top_bottom" value="50.0"/>
+            <brls:Metric name="padding_sides" value="75.0"/>
+            <brls:Metric name="description_margin" value="50.0"/>
+        </brls:Stylesheet>
+    )xml");
+
+    BenchmarkSuite suite(filter);
+
+    benchViewsCreation(&suite);
+    benchXMLInflation(&suite);
+    benchInvalidate(&suite);
+    benchThemeLookups(&suite);
+    benchLabelMeasure(&suite);
+    benchTickings(&suite);
+    benchNavigation(&suite);
+    benchStorageFile(&suite);
+
+    std::string json = suite.toJSON(brls::Application::getPlatform()->getName());
+
+    if (output.empty())
+    {
+        fputs(json.c_str(), stdout);
+    }
+    else
+    {
+        FILE* file = fopen(output.c_str(), "w");
+
+        if (!file)
+        {
+            brls::Logger::error("Cannot write results to \"{}\"", output);
+            return EXIT_FAILURE;
+        }
+
+        fputs(json.c_str(), file);
+        fclose(file);
+    }
+
+    // Exit
+    brls::Application::quit();
+    brls::Application::mainLoop();
+
+    return EXIT_SUCCESS;
+}
@@ -33,3 +33,8 @@ INCLUDES	:=	$(INCLUDES) \
 				$(addprefix $(current_dir)/lib/extern/switch-libpulsar/, $(PLSR_INCLUDES))
 
 CXXFLAGS := $(CXXFLAGS) -DYG_ENABLE_EVENTS -fdata-sections -DBRLS_RESOURCES="\"romfs:/\""
+
+# Set BOREALIS_TRACING to 1 to compile the tracing scopes in (see brls::Tracer)
+ifeq ($(BOREALIS_TRACING),1)
+CXXFLAGS := $(CXXFLAGS) -DBRLS_TRACING=1
+endif
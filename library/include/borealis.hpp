@@ -21,27 +21,41 @@
 #include <borealis/core/actions.hpp>
 #include <borealis/core/activity.hpp>
 #include <borealis/core/animation.hpp>
+#include <borealis/core/arena.hpp>
 #include <borealis/core/application.hpp>
 #include <borealis/core/assets.hpp>
+#include <borealis/core/async.hpp>
 #include <borealis/core/audio.hpp>
 #include <borealis/core/bind.hpp>
 #include <borealis/core/box.hpp>
+#include <borealis/core/coroutine.hpp>
 #include <borealis/core/event.hpp>
 #include <borealis/core/font.hpp>
 #include <borealis/core/frame_context.hpp>
+#include <borealis/core/frame_pacer.hpp>
 #include <borealis/core/i18n.hpp>
+#include <borealis/core/image_atlas.hpp>
+#include <borealis/core/image_decoder.hpp>
 #include <borealis/core/input.hpp>
+#include <borealis/core/key_repeat.hpp>
+#include <borealis/core/latency.hpp>
 #include <borealis/core/logger.hpp>
+#include <borealis/core/memory.hpp>
 #include <borealis/core/platform.hpp>
+#include <borealis/core/shadow_cache.hpp>
+#include <borealis/core/spatial_index.hpp>
+#include <borealis/core/startup.hpp>
 #include <borealis/core/storage_file.hpp>
 #include <borealis/core/style.hpp>
 #include <borealis/core/task.hpp>
 #include <borealis/core/theme.hpp>
 #include <borealis/core/time.hpp>
 #include <borealis/core/timer.hpp>
+#include <borealis/core/trace.hpp>
 #include <borealis/core/util.hpp>
 #include <borealis/core/video.hpp>
 #include <borealis/core/view.hpp>
+#include <borealis/core/view_index.hpp>
 
 //Views
 #include <borealis/views/applet_frame.hpp>
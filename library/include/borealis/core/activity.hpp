@@ -16,7 +16,9 @@
 
 #pragma once
 
+#include <borealis/core/arena.hpp>
 #include <borealis/core/view.hpp>
+#include <memory>
 
 namespace brls
 {
@@ -41,7 +43,7 @@ class Activity
      * Sets the content view of this activity, aka
      * the root view of the tree.
      *
-     * When the activity is pushed, setContentView() is
+     * When the activity is pushed (or preloaded), setContentView() is
      * automatically called with the result of createContentView().
      * As such, you should override createContentView() if you want
      * to use XML in your activity.
@@ -68,9 +70,20 @@ class Activity
     /**
      * Called when the content view is created, so that
      * you can get the references to the activity views (by id).
+     *
+     * The activity can be preloaded (see Application::preloadActivity()): heavy
+     * data loading should then be started here on the task pool, to not stall the frame.
      */
     virtual void onContentAvailable() {};
 
+    /**
+     * Creates the content view with createContentView() (in the arena of the
+     * activity, if enabled), unless it's already done.
+     */
+    void loadContent();
+
+    bool isContentLoaded();
+
     View* getContentView();
 
     /**
@@ -155,8 +168,28 @@ class Activity
 
     void setAlpha(float alpha);
 
+    /**
+     * Creates the content view in an arena owned by the activity: its views and their Yoga nodes
+     * are allocated in a few large blocks, given back at once when the activity
+     * is deleted, instead of one by one. Views created after the content view (when populating
+     * a list later on...) still come from the heap.
+     *
+     * Must be called before the activity is pushed, from its constructor for instance.
+     * Views of the arena deleted after the activity keep its memory alive until the last one goes.
+     */
+    void setArenaEnabled(bool enabled, size_t blockSize = 64 * 1024);
+
+    /**
+     * Returns the arena of the activity, or nullptr if disabled.
+     */
+    Arena* getArena();
+
   private:
-    View* contentView = nullptr;
+    View* contentView  = nullptr;
+    bool contentLoaded = false;
+
+    // Deleted after the content view (members are destroyed after the destructor body)
+    std::unique_ptr<Arena> arena;
 };
 
 } // namespace brls
@@ -18,6 +18,7 @@
 
 #include <tweeny.h>
 
+#include <borealis/core/coroutine.hpp>
 #include <borealis/core/time.hpp>
 
 namespace brls
@@ -45,8 +46,16 @@ class Animatable : public FiniteTicking
      */
     Animatable(float value = 0.0f);
 
+    /**
+     * Resumes the coroutines waiting for the animation to finish:
+     * they must not touch the animatable (or its view) anymore.
+     */
+    ~Animatable();
+
     /**
      * Returns the current animatable value.
+     * If tickings run with a fixed timestep, the value is interpolated
+     * between the last two steps.
      */
     float getValue();
 
@@ -82,20 +91,36 @@ class Animatable : public FiniteTicking
      */
     float getProgress();
 
+#ifdef BRLS_COROUTINES
+    /**
+     * Returns an awaitable suspending the coroutine until the animation
+     * stops, either because it finished or because it was stopped, reset or deleted.
+     * Does not suspend if the animation is not running.
+     */
+    WaitListAwaiter finished()
+    {
+        return { &this->finishWaiters, !this->isRunning() };
+    }
+#endif
+
     operator float() const;
     operator float();
     void operator=(const float value);
     bool operator==(const float value);
 
   protected:
-    bool onUpdate(Time delta) override;
+    bool onUpdate(float delta) override;
 
+    void onStop() override;
     void onReset() override;
     void onRewind() override;
 
   private:
-    float currentValue = 0.0f;
+    float currentValue  = 0.0f;
+    float previousValue = 0.0f;
     tweeny::tween<float> tween;
+
+    CoroutineWaitList finishWaiters;
 };
 
 void updateHighlightAnimation();
@@ -24,12 +24,16 @@
 #include <borealis/core/audio.hpp>
 #include <borealis/core/font.hpp>
 #include <borealis/core/frame_context.hpp>
+#include <borealis/core/frame_pacer.hpp>
+#include <borealis/core/key_repeat.hpp>
 #include <borealis/core/logger.hpp>
 #include <borealis/core/platform.hpp>
+#include <borealis/core/startup.hpp>
 #include <borealis/core/style.hpp>
 #include <borealis/core/theme.hpp>
 #include <borealis/core/view.hpp>
 #include <borealis/views/label.hpp>
+#include <deque>
 #include <unordered_map>
 #include <vector>
 
@@ -56,15 +60,27 @@ class Application
     /**
      * Inits the borealis application.
      * Returns true if it succeeded, false otherwise.
+     *
+     * Stylesheets, translations and font files are loaded in the background
+     * while the window is created, translations and theme lookups made in between
+     * wait for them.
      */
     static bool init();
 
     /**
      * Creates the application window with the given title.
      * Must be called after calling init().
+     *
+     * Finishes the startup started by init() and logs how long each step took.
      */
     static void createWindow(std::string title);
 
+    /**
+     * Blocks until the translations are loaded, if they are still
+     * being loaded in the background. Can be called from any thread.
+     */
+    static void waitForTranslations();
+
     /**
      * Application main loop iteration.
      * Must be called in an infinite loop until it returns false.
@@ -74,6 +90,11 @@ class Application
     static Platform* getPlatform();
     static AudioPlayer* getAudioPlayer();
 
+    /**
+     * Returns the key repeat engine, to change how held buttons repeat.
+     */
+    static KeyRepeater* getKeyRepeater();
+
     static NVGcontext* getNVGContext();
     inline static float contentWidth, contentHeight;
 
@@ -102,16 +123,36 @@ class Application
     static void popActivity(
         TransitionAnimation animation = TransitionAnimation::FADE, std::function<void(void)> cb = [] {});
 
+    /**
+     * Creates the content view of the given activity ahead of time, so that pushing it
+     * later only has to attach and animate it. Activities are preloaded in order, one
+     * per idle frame (no transition running and no input this frame).
+     *
+     * The activity is still owned by the caller until pushed.
+     * Pushing it before it's preloaded creates its content right away, as usual.
+     */
+    static void preloadActivity(Activity* activity);
+
+    /**
+     * Removes the given activity from the preload queue, if it's in it.
+     * Called when an activity is deleted.
+     */
+    static void cancelActivityPreload(Activity* activity);
+
+    /**
+     * Returns the number of activities in the stack, and the number of views
+     * kept in the focus stack to give the focus back when popping them.
+     */
+    static size_t getActivitiesCount();
+    static size_t getFocusStackSize();
+
     /**
      * Gives the focus to the given view
      * or clears the focus if given nullptr.
      */
     static void giveFocus(View* view);
 
-    inline static Style getStyle()
-    {
-        return *style;
-    }
+    static Style getStyle();
 
     static Theme &getTheme();
     static ThemeVariant getThemeVariant();
@@ -159,11 +200,36 @@ class Application
     static void setCommonFooter(std::string footer);
     static std::string* getCommonFooter();
 
+    /**
+     * Shows or hides the framerate in the top left corner of the screen,
+     * with the memory counters if enabled (see MemoryTracker::setOverlayEnabled()).
+     */
     static void setDisplayFramerate(bool enabled);
     static void toggleFramerateDisplay();
 
+    /**
+     * Sets the maximum framerate of the app. 0 removes the limit (default).
+     * If vsync is enabled and the limit is not lower than the display refresh rate,
+     * vsync alone paces the app.
+     */
     static void setMaximumFPS(unsigned fps);
 
+    /**
+     * Enables or disables vsync (enabled by default).
+     * Disabling it without setting a maximum framerate makes the app
+     * run as fast as possible.
+     */
+    static void setVSync(bool enabled);
+
+    /**
+     * Sets the fixed timestep used to update tickings, in ms.
+     * Animations are then interpolated between the last two steps when rendering.
+     * 0 disables fixed timestep (default): tickings are updated once per frame.
+     */
+    static void setFixedTimestep(float timestep);
+
+    static FramePacer* getFramePacer();
+
     inline static float windowScale;
 
     /**
@@ -176,6 +242,12 @@ class Application
      */
     static void setGlobalFPSToggle(bool enabled);
 
+    /**
+     * Sets whether BUTTON_RSB will globally be used to log the memory
+     * counters (see MemoryTracker::log()). Meant for debug builds.
+     */
+    static void setGlobalMemoryDump(bool enabled);
+
     static GenericEvent* getGlobalFocusChangeEvent();
     static VoidEvent* getGlobalHintsUpdateEvent();
 
@@ -213,10 +285,17 @@ class Application
 
     inline static std::string title;
 
+    inline static StartupGraph startup;
+    inline static StartupStep* stylesheetsStep  = nullptr;
+    inline static StartupStep* translationsStep = nullptr;
+    inline static StartupStep* fontFilesStep    = nullptr;
+
     inline static FontStash fontStash;
 
     inline static std::vector<Activity*> activitiesStack;
     inline static std::vector<View*> focusStack;
+    inline static std::deque<Activity*> preloadQueue;
+    inline static bool inputThisFrame = false;
 
     inline static unsigned windowWidth, windowHeight;
 
@@ -230,19 +309,30 @@ class Application
     inline static ActionIdentifier gloablQuitIdentifier      = ACTION_NONE;
     inline static bool globalFPSToggleEnabled                = false;
     inline static ActionIdentifier gloablFPSToggleIdentifier = ACTION_NONE;
+    inline static bool globalMemoryDumpEnabled               = false;
+    inline static ActionIdentifier globalMemoryDumpIdentifier = ACTION_NONE;
 
-    inline static View* repetitionOldFocus = nullptr;
+    inline static bool framerateDisplayed = false;
+
+    inline static KeyRepeater keyRepeater;
+
+    inline static FramePacer framePacer;
+    inline static unsigned maximumFPS = 0;
+    inline static bool vsync          = true;
 
     inline static GenericEvent globalFocusChangeEvent;
     inline static VoidEvent globalHintsUpdateEvent;
 
     inline static std::unordered_map<std::string, XMLViewCreator> xmlViewsRegister;
 
-    static void navigate(FocusDirection direction);
+    static void navigate(FocusDirection direction, bool repeating = false);
 
     static void onWindowSizeChanged();
 
+    static void updateFramePacing();
+
     static void frame();
+    static void preloadNextActivity();
     static void clear();
     static void exit();
 
@@ -256,6 +346,9 @@ class Application
     static void registerBuiltInXMLViews();
 
     static ActionIdentifier registerFPSToggleAction(Activity* activity);
+    static ActionIdentifier registerMemoryDumpAction(Activity* activity);
+
+    static void drawFramerate(NVGcontext* vg);
 };
 
 } // namespace brls
@@ -0,0 +1,110 @@
+/*
+    Copyright 2021 natinusala
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+#pragma once
+
+#include <yoga/Yoga.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace brls
+{
+
+struct ArenaBlocks;
+
+// A bump allocator: allocations are carved out of large blocks one after the other,
+// and their memory is only given back all at once, when the arena is deleted.
+//
+// Used to create whole view trees (views and their Yoga nodes)
+// without thousands of small heap allocations, see Activity::setArenaEnabled().
+// Allocations made while an ArenaScope is open on the current thread go in its arena.
+class Arena
+{
+  public:
+    Arena(size_t blockSize = 64 * 1024);
+
+    /**
+     * Gives the blocks back, unless some allocations are still alive:
+     * the memory is then kept (and a warning logged) until the last of them is deallocated.
+     */
+    ~Arena();
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    /**
+     * Returns the memory used by the blocks, in bytes.
+     */
+    size_t getSize();
+
+    /**
+     * Returns the number of allocations made in the arena and not deallocated yet.
+     */
+    size_t getLiveAllocations();
+
+    /**
+     * Allocates memory in the current arena if there is one, on the heap otherwise.
+     * Must be freed with deallocate(), which finds out where it comes from.
+     */
+    static void* allocate(size_t size);
+    static void deallocate(void* memory);
+
+    /**
+     * Returns the arena of the innermost scope opened on this thread, if any.
+     */
+    static Arena* getCurrent();
+
+    /**
+     * Returns the Yoga config allocating nodes with allocate() (with
+     * the settings of the default config).
+     */
+    static YGConfigRef getYogaConfig();
+
+  private:
+    void* bump(size_t size);
+
+    size_t blockSize;
+    char* cursor = nullptr;
+    char* end    = nullptr;
+
+    size_t size = 0;
+
+    // Outlives the arena if allocations are still alive when it's deleted
+    ArenaBlocks* blocks;
+
+    inline static thread_local Arena* current = nullptr;
+
+    friend class ArenaScope;
+};
+
+// Makes the given arena the current one on this thread while the scope lives.
+// Scopes can be nested, a null arena disables the current one.
+class ArenaScope
+{
+  public:
+    ArenaScope(Arena* arena);
+    ~ArenaScope();
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+  private:
+    Arena* previous;
+};
+
+} // namespace brls
@@ -0,0 +1,267 @@
+/*
+    Copyright 2021 natinusala
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace brls
+{
+
+typedef std::function<void()> AsyncTask;
+
+// A CancellationToken is a read-only view on the state of a CancellationSource.
+// Tokens are cheap to copy and can be safely checked from any thread.
+// A default constructed token is never cancelled.
+class CancellationToken
+{
+  public:
+    CancellationToken() = default;
+
+    /**
+     * Returns true if the source of this token was cancelled (or destroyed).
+     */
+    bool isCancelled() const;
+
+  private:
+    friend class CancellationSource;
+
+    CancellationToken(std::shared_ptr<std::atomic<bool>> state);
+
+    std::shared_ptr<std::atomic<bool>> state;
+};
+
+// A CancellationSource hands out tokens and cancels all of them at once, either
+// when cancel() is called or when the source is destroyed.
+// Every view owns one, see View::getLifetimeToken().
+class CancellationSource
+{
+  public:
+    CancellationSource();
+    ~CancellationSource();
+
+    CancellationSource(const CancellationSource&) = delete;
+    CancellationSource& operator=(const CancellationSource&) = delete;
+
+    /**
+     * Cancels every token given by this source. Cannot be undone.
+     */
+    void cancel();
+
+    bool isCancelled() const;
+
+    CancellationToken getToken() const;
+
+  private:
+    std::shared_ptr<std::atomic<bool>> state;
+};
+
+// Lock-free multiple producers, single consumer queue (Vyukov's intrusive queue).
+// Any thread can push, only one thread can pop.
+template <typename T>
+class MPSCQueue
+{
+  public:
+    MPSCQueue()
+        : head(&stub)
+        , tail(&stub)
+    {
+    }
+
+    ~MPSCQueue()
+    {
+        T value;
+        while (this->pop(&value))
+            ;
+    }
+
+    MPSCQueue(const MPSCQueue&) = delete;
+    MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+    /**
+     * Pushes a value in the queue. Can be called from any thread.
+     */
+    void push(T value)
+    {
+        Node* node = new Node();
+        node->value = std::move(value);
+        this->pushNode(node);
+    }
+
+    /**
+     * Pops a value from the queue. Must only be called from the consumer thread.
+     * Returns false if the queue is empty (or if a push is still in progress).
+     */
+    bool pop(T* value)
+    {
+        Node* tail = this->tail;
+        Node* next = tail->next.load(std::memory_order_acquire);
+
+        // Skip the stub node
+        if (tail == &this->stub)
+        {
+            if (!next)
+                return false;
+
+            this->tail = next;
+            tail       = next;
+            next       = next->next.load(std::memory_order_acquire);
+        }
+
+        if (next)
+        {
+            this->tail = next;
+            *value     = std::move(tail->value);
+            delete tail;
+            return true;
+        }
+
+        // Tail is the last node: put the stub back behind it to be able to take it
+        if (tail != this->head.load(std::memory_order_acquire))
+            return false;
+
+        this->pushNode(&this->stub);
+
+        next = tail->next.load(std::memory_order_acquire);
+        if (next)
+        {
+            this->tail = next;
+            *value     = std::move(tail->value);
+            delete tail;
+            return true;
+        }
+
+        return false;
+    }
+
+  private:
+    struct Node
+    {
+        std::atomic<Node*> next { nullptr };
+        T value;
+    };
+
+    void pushNode(Node* node)
+    {
+        node->next.store(nullptr, std::memory_order_relaxed);
+        Node* previous = this->head.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+    }
+
+    Node stub;
+    std::atomic<Node*> head;
+    Node* tail;
+};
+
+// Pool of worker threads running background tasks (file I/O, decoding, parsing...).
+// Each worker has its own queue and steals from the others when it runs dry.
+// Use brls::async() and brls::sync() instead of using the pool directly.
+class TaskPool
+{
+  public:
+    /**
+     * Starts the pool with the given amount of workers.
+     * 0 means one worker per hardware thread, minus the main thread.
+     * Called automatically with 0 on first use if not started before.
+     */
+    static void start(unsigned workers = 0);
+
+    /**
+     * Stops the pool, waiting for running tasks to finish.
+     * Tasks that did not start yet are discarded, and so are the tasks
+     * submitted afterwards, until start() is called again.
+     * Called by the application on exit.
+     */
+    static void stop();
+
+    /**
+     * Queues a task to be executed on a worker thread.
+     */
+    static void submit(AsyncTask task);
+
+    /**
+     * Queues a task to be executed on the main thread,
+     * at the beginning of the next frame.
+     */
+    static void submitToMainThread(AsyncTask task);
+
+    /**
+     * Called internally by the main loop to execute every task
+     * queued for the main thread.
+     */
+    static void processMainThreadTasks();
+
+    /**
+     * Returns the amount of worker threads.
+     */
+    static unsigned getWorkersCount();
+
+  private:
+    struct Worker
+    {
+        std::thread thread;
+        std::mutex mutex;
+        std::deque<AsyncTask> tasks;
+    };
+
+    static void workerMain(unsigned index);
+    static bool popTask(unsigned index, AsyncTask* task);
+
+    inline static std::vector<std::unique_ptr<Worker>> workers;
+
+    inline static std::mutex sleepMutex;
+    inline static std::condition_variable sleepCondition;
+    inline static std::atomic<unsigned> pendingTasks { 0 };
+    inline static std::atomic<unsigned> nextWorker { 0 };
+    inline static std::atomic<bool> running { false };
+
+    inline static MPSCQueue<AsyncTask> mainThreadTasks;
+};
+
+/**
+ * Executes the given task on a background thread.
+ * The task must not touch any view: use brls::sync() from inside
+ * the task to get back to the main thread.
+ */
+void async(AsyncTask task);
+
+/**
+ * Executes the given task on a background thread, unless the token
+ * gets cancelled before it starts.
+ */
+void async(CancellationToken token, AsyncTask task);
+
+/**
+ * Executes the given task on the main thread, at the beginning of the next frame.
+ * Can be called from any thread.
+ */
+void sync(AsyncTask task);
+
+/**
+ * Executes the given task on the main thread, at the beginning of the next frame,
+ * unless the token is cancelled by then. Give a view lifetime token to
+ * safely update a view from a background task.
+ */
+void sync(CancellationToken token, AsyncTask task);
+
+} // namespace brls
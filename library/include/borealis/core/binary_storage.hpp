@@ -0,0 +1,139 @@
+/*
+    Copyright 2021 natinusala
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace brls
+{
+
+// Read-only view of a whole file. The file is memory-mapped where
+// the platform supports it, and read in memory otherwise.
+class MappedFile
+{
+  public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * Maps the given file, closing the previous one if any.
+     * Returns false if the file could not be opened.
+     */
+    bool open(const std::string& path);
+    void close();
+
+    const uint8_t* getData();
+    size_t getSize();
+
+  private:
+    const uint8_t* data = nullptr;
+    size_t size         = 0;
+    bool mapped         = false;
+
+    std::vector<uint8_t> buffer; // when the file could not be mapped
+};
+
+enum class BinaryListType : uint8_t
+{
+    INT = 1, // int32, little-endian
+    FLOAT, // IEEE 754 binary32, little-endian
+    BOOL, // one byte per value
+    STRING, // table of (count + 1) uint32 offsets followed by the characters
+};
+
+// Append-only binary file holding list properties, used by storage files
+// created with the binary list backend (see BRLS_STORAGE_FILE_INIT_BINARY_LISTS).
+//
+// The file starts with a versioned header followed by records. Each record
+// replaces a list or extends it with new values, and carries a checksum:
+// a torn record at the end of the file (crash while writing) is ignored and
+// overwritten by the next write. Values are read directly from the mapped
+// file, without any parsing.
+//
+// Saving a list that only got new values at its end only writes these new values.
+// The file is compacted once most of it is made of outdated records.
+class BinaryListFile
+{
+  public:
+    /**
+     * Opens the given file, creating it on first write if it does not exist.
+     * Returns false if the file exists but is not a valid list file.
+     */
+    bool open(std::string path);
+
+    bool read(const std::string& name, std::vector<int>& values);
+    bool read(const std::string& name, std::vector<float>& values);
+    bool read(const std::string& name, std::vector<bool>& values);
+    bool read(const std::string& name, std::vector<std::string>& values);
+
+    bool write(const std::string& name, const std::vector<int>& values);
+    bool write(const std::string& name, const std::vector<float>& values);
+    bool write(const std::string& name, const std::vector<bool>& values);
+    bool write(const std::string& name, const std::vector<std::string>& values);
+
+    /**
+     * Rewrites the file with only one record per list.
+     */
+    bool compact();
+
+  private:
+    struct Segment
+    {
+        size_t offset; // of the payload, in the file
+        uint32_t count;
+        uint32_t size;
+    };
+
+    struct List
+    {
+        BinaryListType type;
+        std::vector<Segment> segments;
+        size_t count = 0;
+        size_t size  = 0; // on disk, records included
+    };
+
+    std::string path;
+    bool opened = false;
+
+    MappedFile file;
+    bool stale = false; // the mapped file is behind the file on the disk
+
+    size_t fileSize = 0; // valid part of the file, on disk
+    std::unordered_map<std::string, List> lists;
+
+    bool load();
+    const uint8_t* getData();
+    List* getList(const std::string& name, BinaryListType type);
+
+    bool append(const std::string& name, BinaryListType type, bool extend, uint32_t count, const std::vector<uint8_t>& payload);
+    void onListWritten();
+
+    template <typename T>
+    bool readList(const std::string& name, std::vector<T>& values);
+
+    template <typename T>
+    bool writeList(const std::string& name, const std::vector<T>& values);
+};
+
+} // namespace brls
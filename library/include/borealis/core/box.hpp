@@ -62,6 +62,7 @@ class Box : public View
   public:
     Box(Axis flexDirection);
     Box();
+    ~Box();
 
     void draw(NVGcontext* vg, float x, float y, float width, float height, Style style, FrameContext* ctx) override;
     View* getDefaultFocus() override;
@@ -94,6 +95,32 @@ class Box : public View
      */
     virtual void removeView(View* view);
 
+    /**
+     * Adds the given views at the end of the Box (or at the given position),
+     * with a single layout pass for all of them.
+     */
+    void addViews(const std::vector<View*>& views);
+    virtual void addViews(const std::vector<View*>& views, size_t position);
+
+    /**
+     * Removes the given number of views starting from the given position,
+     * with a single layout pass. They will be freed.
+     */
+    virtual void removeViewsRange(size_t start, size_t count);
+
+    /**
+     * Removes every view of the Box, with a single layout pass. They will be freed.
+     */
+    virtual void removeAllViews();
+
+    /**
+     * Removes the given view from the Box without freeing it:
+     * it's then owned by the caller, who can add it to another Box.
+     * The IDs of its children stay reachable with getView().
+     * Returns false if the view is not a child of the Box.
+     */
+    virtual bool detachView(View* view);
+
     /**
      * Sets the padding of the view, aka the internal space to give
      * between this view boundaries and its children.
@@ -158,6 +185,24 @@ class Box : public View
 
     void setAxis(Axis axis);
 
+    /**
+     * Enables or disables spatial navigation in the Box. When enabled, the focus
+     * moves from any view inside the Box to the closest focusable view inside the Box
+     * in the pressed direction, based on their position on screen instead of
+     * the order of the children. Nested boxes are not needed anymore to make grids.
+     *
+     * Only leaves the Box when there is no view in that direction.
+     * Custom navigation routes still take precedence.
+     *
+     * Views are indexed by their position relative to the Box: enable it on the Box
+     * holding the views, not on a ScrollingFrame around it.
+     *
+     * Default is false.
+     */
+    void setSpatialNavigationEnabled(bool enabled);
+
+    bool isSpatialNavigationEnabled();
+
     std::vector<View*>& getChildren();
 
     /**
@@ -202,15 +247,29 @@ class Box : public View
 
     View* getView(std::string id) override;
 
+  protected:
+    ViewIndex* getViewIndex(bool create) override;
+
   private:
     Axis axis;
 
     std::vector<View*> children;
+    size_t detachedChildren = 0; // children without a node in ours
+
+    // IDs of every view of the tree, only if this Box is the root of its tree
+    std::unique_ptr<ViewIndex> viewIndex;
+
+    std::unique_ptr<SpatialIndex> spatialIndex; // only if spatial navigation is enabled
 
     size_t defaultFocusedIndex = 0;
 
     std::unordered_map<std::string, std::pair<std::string, View*>> forwardedAttributes;
 
+    size_t getNodeIndex(size_t position);
+    void insertChild(View* view, size_t position);
+    void updateChildrenIndices(size_t from);
+    void removeChildren(size_t start, size_t count, bool free);
+
   protected:
     /**
      * Inflates the Box with the given XML string.
@@ -0,0 +1,301 @@
+/*
+    Copyright 2021 natinusala
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#pragma once
+
+#include <borealis/core/async.hpp>
+#include <borealis/core/time.hpp>
+#include <vector>
+
+// Coroutines are only available when building with C++20
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#define BRLS_COROUTINES
+#endif
+
+namespace brls
+{
+
+// Type-erased handle to a suspended coroutine, so that the scheduler
+// can be built and driven by the main loop even without C++20
+struct CoroutineResumer
+{
+    void (*resume)(void* address);
+    void* address;
+};
+
+// Resumes suspended coroutines from the main loop, once per frame, after tickings are updated.
+// Everything here must be called from the main thread.
+class CoroutineScheduler
+{
+  public:
+    /**
+     * Resumes the coroutine during the next frame.
+     */
+    static void resumeNextFrame(CoroutineResumer resumer);
+
+    /**
+     * Resumes the coroutine during the first frame after
+     * the given time (in µs, see getCPUTimeUsec()).
+     */
+    static void resumeAt(CoroutineResumer resumer, Time time);
+
+    /**
+     * Resumes the coroutine as soon as possible, either during the
+     * current frame if the scheduler did not run yet, or the next one.
+     */
+    static void resumeSoon(CoroutineResumer resumer);
+
+    /**
+     * Called internally by the main loop to resume every coroutine due this frame.
+     */
+    static void update();
+
+  private:
+    struct FrameResumer
+    {
+        CoroutineResumer resumer;
+        uint64_t frame;
+    };
+
+    struct TimedResumer
+    {
+        CoroutineResumer resumer;
+        Time time;
+
+        bool operator>(const TimedResumer& other) const
+        {
+            return this->time > other.time;
+        }
+    };
+
+    inline static uint64_t frame = 0;
+
+    inline static std::vector<FrameResumer> frameResumers;
+    inline static std::vector<TimedResumer> timedResumers; // min-heap on time
+    inline static std::vector<CoroutineResumer> resuming;
+};
+
+// List of coroutines waiting for something to happen (like an animation finishing).
+// Releasing the list hands all of them to the scheduler.
+class CoroutineWaitList
+{
+  public:
+    void add(CoroutineResumer resumer);
+
+    /**
+     * Schedules every waiting coroutine to be resumed and clears the list.
+     */
+    void release();
+
+    bool empty();
+
+  private:
+    std::vector<CoroutineResumer> waiters;
+};
+
+#ifdef BRLS_COROUTINES
+
+// Called when an exception escapes a coroutine: nothing owns the coroutine
+// to rethrow it to, so it is logged before terminating.
+[[noreturn]] void coroutineUnhandledException();
+
+// Return type of a borealis coroutine. The coroutine starts right away, runs on the main
+// thread until its first suspension point, and destroys itself when it returns.
+//
+//   brls::Coroutine populate(brls::Box* box)
+//   {
+//       for (int i = 0; i < 1000; i++)
+//       {
+//           box->addView(new brls::Label());
+//
+//           if (i % 50 == 0)
+//               co_await brls::nextFrame();
+//       }
+//   }
+//
+// The coroutine is not bound to any view: if it touches one, check a lifetime token
+// (see View::getLifetimeToken()) after each suspension point.
+class Coroutine
+{
+  public:
+    struct promise_type
+    {
+        Coroutine get_return_object()
+        {
+            return {};
+        }
+
+        std::suspend_never initial_suspend() noexcept
+        {
+            return {};
+        }
+
+        std::suspend_never final_suspend() noexcept
+        {
+            return {};
+        }
+
+        void return_void() { }
+
+        void unhandled_exception()
+        {
+            coroutineUnhandledException();
+        }
+    };
+};
+
+inline CoroutineResumer makeCoroutineResumer(std::coroutine_handle<> handle)
+{
+    return CoroutineResumer {
+        [](void* address) { std::coroutine_handle<>::from_address(address).resume(); },
+        handle.address(),
+    };
+}
+
+struct NextFrameAwaiter
+{
+    bool await_ready()
+    {
+        return false;
+    }
+
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        CoroutineScheduler::resumeNextFrame(makeCoroutineResumer(handle));
+    }
+
+    void await_resume() { }
+};
+
+struct DelayAwaiter
+{
+    float delay; // ms
+
+    bool await_ready()
+    {
+        return this->delay <= 0.0f;
+    }
+
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        CoroutineScheduler::resumeAt(makeCoroutineResumer(handle), getCPUTimeUsec() + (Time)(this->delay * 1000.0f));
+    }
+
+    void await_resume() { }
+};
+
+struct WaitListAwaiter
+{
+    CoroutineWaitList* waitList;
+    bool ready;
+
+    bool await_ready()
+    {
+        return this->ready;
+    }
+
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        this->waitList->add(makeCoroutineResumer(handle));
+    }
+
+    void await_resume() { }
+};
+
+template <typename Function>
+struct WorkerAwaiter
+{
+    using Result = std::invoke_result_t<Function>;
+
+    Function function;
+    std::optional<std::conditional_t<std::is_void_v<Result>, bool, Result>> result;
+    std::exception_ptr exception;
+
+    bool await_ready()
+    {
+        return false;
+    }
+
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        // The awaiter lives in the coroutine frame, which stays alive while suspended
+        async([this, handle]() {
+            try
+            {
+                if constexpr (std::is_void_v<Result>)
+                {
+                    this->function();
+                    this->result = true;
+                }
+                else
+                {
+                    this->result = this->function();
+                }
+            }
+            catch (...)
+            {
+                this->exception = std::current_exception();
+            }
+
+            sync([handle]() { handle.resume(); });
+        });
+    }
+
+    Result await_resume()
+    {
+        if (this->exception)
+            std::rethrow_exception(this->exception);
+
+        if constexpr (!std::is_void_v<Result>)
+            return std::move(*this->result);
+    }
+};
+
+/**
+ * Suspends the coroutine until the next frame.
+ */
+inline NextFrameAwaiter nextFrame()
+{
+    return {};
+}
+
+/**
+ * Suspends the coroutine for the given amount of time, in ms.
+ * The coroutine is resumed during the first frame after the delay.
+ */
+inline DelayAwaiter delay(float ms)
+{
+    return { ms };
+}
+
+/**
+ * Runs the given function on a worker thread (see brls::async()) and suspends
+ * the coroutine until it returns. The coroutine is then resumed on the main thread
+ * and the co_await expression evaluates to the return value of the function.
+ */
+template <typename Function>
+WorkerAwaiter<Function> onWorker(Function function)
+{
+    return { std::move(function) };
+}
+
+#endif
+
+} // namespace brls
@@ -16,13 +16,244 @@
 
 #pragma once
 
+#include <stdint.h>
+
 #include <algorithm>
-#include <functional>
-#include <list>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace brls
 {
 
+template <typename Signature>
+class SmallFunction;
+
+// Type-erased callable, like std::function, that stores small callables (up to four
+// pointers, which covers most lambdas) inline instead of allocating them
+template <typename R, typename... Args>
+class SmallFunction<R(Args...)>
+{
+  public:
+    SmallFunction() = default;
+
+    template <typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, SmallFunction>>>
+    SmallFunction(F&& function)
+    {
+        this->emplace<std::decay_t<F>>(std::forward<F>(function));
+    }
+
+    SmallFunction(const SmallFunction& other)
+    {
+        if (other.operations)
+        {
+            other.operations->copy(this->buffer, other.buffer);
+            this->operations = other.operations;
+        }
+    }
+
+    SmallFunction(SmallFunction&& other) noexcept
+    {
+        if (other.operations)
+        {
+            other.operations->move(this->buffer, other.buffer);
+            this->operations  = other.operations;
+            other.operations = nullptr;
+        }
+    }
+
+    SmallFunction& operator=(const SmallFunction& other)
+    {
+        if (this != &other)
+        {
+            SmallFunction copy(other);
+            *this = std::move(copy);
+        }
+
+        return *this;
+    }
+
+    SmallFunction& operator=(SmallFunction&& other) noexcept
+    {
+        if (this != &other)
+        {
+            this->reset();
+
+            if (other.operations)
+            {
+                other.operations->move(this->buffer, other.buffer);
+                this->operations  = other.operations;
+                other.operations = nullptr;
+            }
+        }
+
+        return *this;
+    }
+
+    ~SmallFunction()
+    {
+        this->reset();
+    }
+
+    R operator()(Args... args)
+    {
+        return this->operations->invoke(this->buffer, std::forward<Args>(args)...);
+    }
+
+    explicit operator bool() const
+    {
+        return this->operations != nullptr;
+    }
+
+    void reset()
+    {
+        if (this->operations)
+        {
+            this->operations->destroy(this->buffer);
+            this->operations = nullptr;
+        }
+    }
+
+  private:
+    static constexpr size_t BUFFER_SIZE = 4 * sizeof(void*);
+
+    struct Operations
+    {
+        R (*invoke)(void* storage, Args&&... args);
+        void (*copy)(void* destination, const void* source);
+        void (*move)(void* destination, void* source);
+        void (*destroy)(void* storage);
+    };
+
+    template <typename F>
+    static constexpr bool isInline = sizeof(F) <= BUFFER_SIZE && alignof(F) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<F>;
+
+    template <typename F>
+    static F* get(void* storage)
+    {
+        if constexpr (isInline<F>)
+            return static_cast<F*>(storage);
+        else
+            return *static_cast<F**>(storage);
+    }
+
+    template <typename F>
+    static const Operations* getOperations()
+    {
+        static const Operations operations = {
+            [](void* storage, Args&&... args) -> R {
+                return (*get<F>(storage))(std::forward<Args>(args)...);
+            },
+            [](void* destination, const void* source) {
+                const F* function = get<F>(const_cast<void*>(source));
+
+                if constexpr (isInline<F>)
+                    new (destination) F(*function);
+                else
+                    *static_cast<F**>(destination) = new F(*function);
+            },
+            [](void* destination, void* source) {
+                if constexpr (isInline<F>)
+                {
+                    new (destination) F(std::move(*get<F>(source)));
+                    get<F>(source)->~F();
+                }
+                else
+                {
+                    *static_cast<F**>(destination) = *static_cast<F**>(source);
+                }
+            },
+            [](void* storage) {
+                if constexpr (isInline<F>)
+                    get<F>(storage)->~F();
+                else
+                    delete get<F>(storage);
+            },
+        };
+
+        return &operations;
+    }
+
+    template <typename F, typename Arg>
+    void emplace(Arg&& function)
+    {
+        if constexpr (isInline<F>)
+            new (this->buffer) F(std::forward<Arg>(function));
+        else
+            *reinterpret_cast<F**>(this->buffer) = new F(std::forward<Arg>(function));
+
+        this->operations = getOperations<F>();
+    }
+
+    alignas(std::max_align_t) unsigned char buffer[BUFFER_SIZE];
+    const Operations* operations = nullptr;
+};
+
+typedef uint64_t EventSubscription;
+
+// Subscription that unsubscribes automatically when destroyed.
+// Must not outlive the event it was obtained from.
+class ScopedSubscription
+{
+  public:
+    ScopedSubscription() = default;
+
+    ScopedSubscription(void* event, void (*unsubscribe)(void* event, EventSubscription subscription), EventSubscription subscription)
+        : event(event)
+        , unsubscribe(unsubscribe)
+        , subscription(subscription)
+    {
+    }
+
+    ScopedSubscription(const ScopedSubscription&) = delete;
+    ScopedSubscription& operator=(const ScopedSubscription&) = delete;
+
+    ScopedSubscription(ScopedSubscription&& other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    ScopedSubscription& operator=(ScopedSubscription&& other) noexcept
+    {
+        if (this != &other)
+        {
+            this->reset();
+
+            this->event        = other.event;
+            this->unsubscribe  = other.unsubscribe;
+            this->subscription = other.subscription;
+
+            other.event = nullptr;
+        }
+
+        return *this;
+    }
+
+    ~ScopedSubscription()
+    {
+        this->reset();
+    }
+
+    /**
+     * Unsubscribes now, if still subscribed.
+     */
+    void reset()
+    {
+        if (this->event)
+        {
+            this->unsubscribe(this->event, this->subscription);
+            this->event = nullptr;
+        }
+    }
+
+  private:
+    void* event                                   = nullptr;
+    void (*unsubscribe)(void*, EventSubscription) = nullptr;
+    EventSubscription subscription                = 0;
+};
+
 // Simple observer pattern implementation
 //
 // Usage:
@@ -32,42 +263,155 @@ namespace brls
 // 4. call fire when you want to fire the events
 //    it wil return true if at least one subscriber exists
 //    for that event
+//
+// Subscribing and unsubscribing is allowed from inside a callback: subscribers added
+// during a fire will only be called starting from the next one, and unsubscribed
+// subscribers are not called anymore but only removed once the fire is done.
 template <typename... Ts>
 class Event
 {
   public:
-    typedef std::function<void(Ts...)> Callback;
-    typedef std::list<Callback> CallbacksList;
-    typedef typename CallbacksList::iterator Subscription;
+    typedef SmallFunction<void(Ts...)> Callback;
+    typedef EventSubscription Subscription;
+
+    Event() = default;
+
+    Event(const Event&) = delete;
+    Event& operator=(const Event&) = delete;
 
     Subscription subscribe(Callback cb);
     void unsubscribe(Subscription subscription);
+
+    /**
+     * Subscribes to the event, returning a subscription
+     * that unsubscribes when destroyed.
+     */
+    ScopedSubscription subscribeScoped(Callback cb);
+
     bool fire(Ts... args);
 
   private:
-    CallbacksList callbacks;
+    struct Slot
+    {
+        Subscription subscription; // 0 if unsubscribed during a fire
+        Callback callback;
+    };
+
+    // Sorted by subscription since subscriptions are increasing
+    std::vector<Slot> slots;
+    std::vector<Slot> pendingSlots; // subscribed during a fire
+
+    Subscription nextSubscription = 1;
+    unsigned fireDepth            = 0;
+    bool hasDeadSlots             = false;
+
+    void flush();
+
+    static void unsubscribeFrom(void* event, Subscription subscription);
 };
 
 template <typename... Ts>
 typename Event<Ts...>::Subscription Event<Ts...>::subscribe(Event<Ts...>::Callback cb)
 {
-    this->callbacks.push_back(cb);
-    return --this->callbacks.end();
+    Subscription subscription = this->nextSubscription++;
+
+    if (this->fireDepth > 0)
+        this->pendingSlots.push_back({ subscription, std::move(cb) });
+    else
+        this->slots.push_back({ subscription, std::move(cb) });
+
+    return subscription;
+}
+
+template <typename... Ts>
+ScopedSubscription Event<Ts...>::subscribeScoped(Event<Ts...>::Callback cb)
+{
+    return ScopedSubscription(this, Event<Ts...>::unsubscribeFrom, this->subscribe(std::move(cb)));
+}
+
+template <typename... Ts>
+void Event<Ts...>::unsubscribeFrom(void* event, Subscription subscription)
+{
+    static_cast<Event<Ts...>*>(event)->unsubscribe(subscription);
 }
 
 template <typename... Ts>
 void Event<Ts...>::unsubscribe(Event<Ts...>::Subscription subscription)
 {
-    this->callbacks.erase(subscription);
+    auto bySubscription = [](const Slot& slot, Subscription subscription) { return slot.subscription < subscription; };
+
+    auto it = std::lower_bound(this->slots.begin(), this->slots.end(), subscription, bySubscription);
+
+    if (it != this->slots.end() && it->subscription == subscription)
+    {
+        // The callback might be the one running right now, only mark it dead
+        if (this->fireDepth > 0)
+        {
+            it->subscription   = 0;
+            this->hasDeadSlots = true;
+        }
+        else
+        {
+            this->slots.erase(it);
+        }
+
+        return;
+    }
+
+    it = std::lower_bound(this->pendingSlots.begin(), this->pendingSlots.end(), subscription, bySubscription);
+
+    if (it != this->pendingSlots.end() && it->subscription == subscription)
+        this->pendingSlots.erase(it);
 }
 
 template <typename... Ts>
 bool Event<Ts...>::fire(Ts... args)
 {
-    for (Callback cb : this->callbacks)
-        cb(args...);
+    bool fired = false;
+
+    this->fireDepth++;
+
+    // Slots cannot move during the fire: new subscribers go to pendingSlots
+    // and unsubscribed slots are only marked dead
+    size_t count = this->slots.size();
+    for (size_t i = 0; i < count; i++)
+    {
+        Slot& slot = this->slots[i];
+
+        if (slot.subscription == 0)
+            continue;
+
+        slot.callback(args...);
+        fired = true;
+    }
+
+    this->fireDepth--;
+
+    if (this->fireDepth == 0)
+        this->flush();
+
+    return fired;
+}
+
+template <typename... Ts>
+void Event<Ts...>::flush()
+{
+    if (this->hasDeadSlots)
+    {
+        this->slots.erase(
+            std::remove_if(this->slots.begin(), this->slots.end(), [](const Slot& slot) { return slot.subscription == 0; }),
+            this->slots.end());
+
+        this->hasDeadSlots = false;
+    }
+
+    if (!this->pendingSlots.empty())
+    {
+        for (Slot& slot : this->pendingSlots)
+            this->slots.push_back(std::move(slot));
 
-    return !this->callbacks.empty();
+        this->pendingSlots.clear();
+    }
 }
 
 }; // namespace brls
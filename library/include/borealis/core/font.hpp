@@ -35,7 +35,15 @@ typedef std::unordered_map<std::string, int> FontStash;
 class FontLoader
 {
   public:
-    virtual ~FontLoader() {}
+    virtual ~FontLoader();
+
+    /**
+     * Called once on init, on a background thread, before the window and
+     * the graphics context exist. Can be overridden to read the font files in memory
+     * with preloadFontFile() so that loadFonts() doesn't wait for the disk.
+     */
+    virtual void preloadFonts() {}
+
     /**
      * Called once on init to load every font in the font stash.
      *
@@ -52,11 +60,34 @@ class FontLoader
      */
     bool loadFontFromFile(std::string fontName, std::string filePath);
 
+    /**
+     * Reads the given font file in memory, to be used by the next
+     * loadFontFromFile() call with the same path. Missing files are ignored.
+     */
+    void preloadFontFile(std::string filePath);
+
+    /**
+     * Reads the Material icons font from resources in memory,
+     * see preloadFontFile().
+     */
+    void preloadMaterialFromResources();
+
     /**
      * Can be called internally to load the Material icons font from resources.
      * Returns true if the operation succeeds.
      */
     bool loadMaterialFromResources();
+
+  private:
+    struct PreloadedFont
+    {
+        unsigned char* data; // allocated with malloc, given to nanovg that frees it
+        size_t size;
+    };
+
+    // Written by preloadFonts() on a background thread, only read
+    // by loadFonts() once the startup step is joined
+    std::unordered_map<std::string, PreloadedFont> preloadedFonts;
 };
 
 } // namespace brls
@@ -0,0 +1,118 @@
+/*
+    Copyright 2021 natinusala
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#pragma once
+
+#include <borealis/core/time.hpp>
+
+namespace brls
+{
+
+// The frame pacer measures frame times on the monotonic microsecond clock and
+// makes the main loop run at a steady rate.
+//
+// By default the app is paced by vsync: the swap blocks until the display refreshes
+// and the pacer only measures. A target framerate can be set to cap the app
+// below the display rate. The pacer then sleeps at the end of each frame, and spins
+// for the last part of the wait to hit the deadline precisely.
+//
+// Tickings can either be updated once per frame with the measured delta (default), or
+// with a fixed timestep: the pacer then accumulates the elapsed time and tells
+// the main loop how many fixed steps to run, as well as the interpolation factor
+// between the last two steps to use for rendering.
+class FramePacer
+{
+  public:
+    /**
+     * Sets the maximum framerate of the app, in frames per second.
+     * 0 disables the limiter (the app is then only paced by vsync, if enabled).
+     */
+    void setTargetFramerate(unsigned fps);
+
+    unsigned getTargetFramerate();
+
+    /**
+     * Sets the fixed timestep to use for tickings, in ms.
+     * 0 disables it, tickings are then updated once per frame with the frame delta.
+     */
+    void setFixedTimestep(float timestep);
+
+    float getFixedTimestep();
+
+    /**
+     * Called by the main loop at the beginning of every frame, right
+     * before sampling inputs.
+     */
+    void beginFrame();
+
+    /**
+     * Called by the main loop at the end of every frame, after presenting.
+     * Sleeps until the next frame deadline if a target framerate is set.
+     */
+    void endFrame();
+
+    /**
+     * Returns true and consumes one step from the accumulator if
+     * a fixed step should be run this frame. Always returns false if
+     * fixed timestep is disabled.
+     */
+    bool consumeFixedStep();
+
+    /**
+     * Returns the time elapsed between the beginning of the previous
+     * frame and the beginning of the current one, in ms.
+     */
+    float getFrameDelta();
+
+    /**
+     * Returns the time at which the current frame started, in µs.
+     */
+    Time getFrameStartTime();
+
+    /**
+     * Returns the interpolation factor between the previous and the
+     * current fixed step, between 0.0f and 1.0f.
+     * Always 1.0f if fixed timestep is disabled.
+     */
+    float getInterpolationAlpha();
+
+    /**
+     * Returns the average frame time over the last frames, in ms.
+     */
+    float getAverageFrameTime();
+
+    /**
+     * Returns the average framerate over the last frames, in frames per second.
+     */
+    float getFramerate();
+
+  private:
+    unsigned targetFramerate = 0;
+    Time targetFrameTime     = 0; // µs
+
+    float fixedTimestep = 0.0f;
+    float accumulator   = 0.0f;
+
+    Time frameStart    = 0;
+    Time frameDeadline = 0;
+
+    float frameDelta       = 0.0f;
+    float averageFrameTime = 0.0f;
+
+    void sleepUntil(Time deadline);
+};
+
+} // namespace brls
@@ -18,9 +18,12 @@
 #pragma once
 
 #include <fmt/core.h>
+#include <fmt/format.h>
+#include <stdint.h>
 
 #include <borealis/core/logger.hpp>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace brls
@@ -60,15 +63,106 @@ const char pathSeperator = // To check if a directory in the i18n folder is vali
     '/';
 #endif
 
+// Key of a translated string, with its hash computed at compile time
+// when the key is a literal, so that lookups don't hash it every time.
+// Only holds a view to the name: it must outlive the key.
+class I18nKey
+{
+  public:
+    constexpr I18nKey(std::string_view name)
+        : name(name)
+        , hash(I18nKey::hashName(name))
+    {
+    }
+
+    constexpr I18nKey(const char* name)
+        : I18nKey(std::string_view(name))
+    {
+    }
+
+    I18nKey(const std::string& name)
+        : I18nKey(std::string_view(name))
+    {
+    }
+
+    constexpr std::string_view getName() const
+    {
+        return this->name;
+    }
+
+    constexpr uint64_t getHash() const
+    {
+        return this->hash;
+    }
+
+    /**
+     * 64-bit FNV-1a, same as the one used by the catalog compiler.
+     */
+    static constexpr uint64_t hashName(std::string_view name)
+    {
+        uint64_t hash = 0xCBF29CE484222325;
+
+        for (char c : name)
+        {
+            hash ^= (uint8_t)c;
+            hash *= 0x100000001B3;
+        }
+
+        return hash;
+    }
+
+  private:
+    std::string_view name;
+    uint64_t hash;
+};
+
 namespace internal
 {
+    /**
+     * Returns the translation for the given string, looking in the current locale,
+     * then the default locale, then the internal translations.
+     * The returned view stays valid until translations are loaded again.
+     */
+    std::string_view findRawStr(I18nKey key);
+
+    /**
+     * Same as findRawStr(), as a string. Internal translations are always
+     * looked up last, the internal flag is only kept for compatibility.
+     */
     std::string getRawStr(std::string stringName, bool internal = false);
+
+    // Translation split in literal text and arguments, parsed once
+    // per string and locale then cached
+    struct I18nFormat
+    {
+        struct Piece
+        {
+            std::string text; // if argument is -1
+            int argument;
+        };
+
+        std::string_view raw;
+        bool simple; // only {} and {n} placeholders, otherwise the string is given to fmt as is
+        std::vector<Piece> pieces;
+        size_t argumentsCount;
+    };
+
+    /**
+     * Returns the parsed translation of the given string.
+     * Stays valid until translations are loaded again.
+     */
+    const I18nFormat* getFormat(I18nKey key);
+
+    std::string assembleFormat(const I18nFormat* format, const std::string* arguments);
 } // namespace internal
 
 /**
  * Checks the i18n folder for stray directories, files, and
  * XML files (ones that aren't i18n XML Files). Returns a vector containing
  * all the warnings.
+ *
+ * Already done by scripts/i18n-compile.py when compiling the catalogs,
+ * so it only runs at startup if they are missing.
  */
 void i18nChecker();
 
@@ -79,41 +173,66 @@ void loadInternal();
  * after injecting format parameters (if any)
  */
 template <typename... Args>
-std::string getStr(std::string stringName, Args&&... args)
+std::string getStr(I18nKey key, Args&&... args)
 {
-    std::string rawStr = internal::getRawStr(stringName);
+    const internal::I18nFormat* format = internal::getFormat(key);
+
+    // Only format the arguments and glue them with the text in between
+    if (format->simple && format->argumentsCount <= sizeof...(Args))
+    {
+        std::string arguments[sizeof...(Args) + 1] = { fmt::to_string(args)... };
+        return internal::assembleFormat(format, arguments);
+    }
 
     try
     {
-        return fmt::format(rawStr, args...);
+        return fmt::format(format->raw, args...);
     }
     catch (const std::exception& e)
     {
-        Logger::error("Invalid format \"{}\" from string \"{}\": {}", rawStr, stringName, e.what());
-        return stringName;
+        Logger::error("Invalid format \"{}\" from string \"{}\": {}", format->raw, key.getName(), e.what());
+        return std::string(key.getName());
     }
 }
 
 /**
  * Loads all translations of the current system locale + default locale + internal translations
  * Must be called before trying to get a translation!
+ *
+ * Locales compiled by scripts/i18n-compile.py ("i18n/<locale>.brlsi18n") are memory-mapped
+ * and used as-is, otherwise the XML files of the locale are parsed.
  */
 void loadTranslations();
 
 inline namespace literals
 {
+    /**
+     * Returns the key of the given string, hashed at compile time,
+     * to be given to brls::getStr()
+     */
+    constexpr I18nKey operator"" _i18nKey(const char* str, size_t len)
+    {
+        return I18nKey(std::string_view(str, len));
+    }
+
     /**
      * Returns the translation for the given string, without
      * injecting any parameters
      * Shortcut to brls::getStr(stringName)
      */
-    std::string operator"" _i18n(const char* str, size_t len);
+    inline std::string operator"" _i18n(const char* str, size_t len)
+    {
+        return std::string(internal::findRawStr(I18nKey(std::string_view(str, len))));
+    }
 
     /**
      * Returns the internal translation for the given string, without
      * injecting any parameters
      * Shortcut to brls::internal::getRawStr(stringName, true)
      */
-    std::string operator"" _internal(const char* str, size_t len);
+    inline std::string operator"" _internal(const char* str, size_t len)
+    {
+        return std::string(internal::findRawStr(I18nKey(std::string_view(str, len))));
+    }
 } // namespace literals
 } // namespace brls
@@ -0,0 +1,144 @@
+/*
+    Copyright 2021 natinusala
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+#pragma once
+
+#include <nanovg.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace brls
+{
+
+// An image packed in an atlas page
+struct AtlasImage
+{
+    int texture = 0; // of the page
+
+    // Region of the image in the page, in px
+    int x = 0, y = 0;
+    int width = 0, height = 0;
+
+    int pageWidth = 0, pageHeight = 0;
+
+    /**
+     * Returns a paint drawing the image in the given rectangle.
+     *
+     * The image can move when its page is repacked,
+     * so the paint should not be kept from a frame to another.
+     */
+    NVGpaint getPaint(NVGcontext* vg, float x, float y, float width, float height, float alpha) const;
+};
+
+// Packs small images in shared textures (pages), so that drawing a lot of them
+// doesn't need to switch textures all the time and can be merged in a few draw calls.
+//
+// Images are grouped by name: images of the same group share pages. Images without a group
+// go in the default group if they are smaller than the size threshold.
+// The same file loaded twice in the same group is only packed once.
+//
+// Pages are packed with shelves: rows of images of similar heights. Removed images leave holes
+// that are reclaimed by repacking the page once it's full.
+//
+// Everything here must be called from the main thread.
+class ImageAtlas
+{
+  public:
+    /**
+     * Loads the given image file in a page of the given group. With an empty group,
+     * the image is only packed if it's smaller than the size threshold.
+     *
+     * Returns nullptr if the image is not packed (too large, cannot be read...): it should
+     * then be loaded in its own texture. The image must be released with release().
+     */
+    static AtlasImage* load(NVGcontext* vg, std::string path, std::string group, int imageFlags);
+
+    /**
+     * Releases an image loaded with load(). Pages are deleted once empty.
+     */
+    static void release(NVGcontext* vg, AtlasImage* image);
+
+    /**
+     * Sets the maximum size (width and height, in px) of the images packed
+     * without a group. 0 disables it. Default is 64.
+     */
+    static void setSizeThreshold(int size);
+
+    static int getSizeThreshold();
+
+    /**
+     * Sets the size of new pages, in px. Default is 1024.
+     */
+    static void setPageSize(int size);
+
+    /**
+     * Returns the number of pages currently allocated.
+     */
+    static size_t getPageCount();
+
+    /**
+     * Returns the memory used by the pages, in bytes: their texture and
+     * the copy of their pixels kept to repack them.
+     */
+    static size_t getMemoryUsage();
+
+  private:
+    struct Page;
+
+    struct Entry : AtlasImage
+    {
+        std::string key;
+        Page* page;
+        unsigned references;
+    };
+
+    struct Shelf
+    {
+        int y, height;
+        int width; // used
+    };
+
+    struct Page
+    {
+        std::string group;
+        int flags;
+
+        int texture;
+        int width, height;
+        std::vector<unsigned char> pixels; // to repack it
+
+        std::vector<Shelf> shelves;
+        int shelvesHeight = 0;
+
+        std::vector<Entry*> entries;
+        size_t freedArea = 0; // holes left by removed images
+    };
+
+    static bool allocate(Page* page, int width, int height, int* x, int* y);
+    static Page* createPage(NVGcontext* vg, std::string group, int flags);
+    static bool repack(NVGcontext* vg, Page* page);
+
+    inline static std::vector<Page*> pages;
+    inline static std::unordered_map<std::string, Entry*> entries;
+
+    inline static int sizeThreshold = 64;
+    inline static int pageSize      = 1024;
+};
+
+} // namespace brls
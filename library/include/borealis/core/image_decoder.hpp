@@ -0,0 +1,62 @@
+/*
+    Copyright 2021 natinusala
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace brls
+{
+
+// An RGBA image decoded from a file, with premultiplied alpha
+struct DecodedImage
+{
+    std::vector<unsigned char> pixels;
+    int width = 0, height = 0;
+
+    // Size of the image in the file, before downscaling
+    int sourceWidth = 0, sourceHeight = 0;
+};
+
+// Decodes images on the CPU, downscaled if needed, to upload
+// textures no bigger than what is actually drawn.
+class ImageDecoder
+{
+  public:
+    /**
+     * Decodes the given image file, downscaled to fit in the given size (in px)
+     * if it's larger. The aspect ratio is conserved. 0 means no limit.
+     *
+     * Returns false if the file cannot be decoded.
+     */
+    static bool decode(std::string path, int maxWidth, int maxHeight, DecodedImage* image);
+
+    /**
+     * Reads the size of the given image file without decoding it.
+     * Returns false if the file cannot be read.
+     */
+    static bool getSize(std::string path, int* width, int* height);
+
+    /**
+     * Downscales premultiplied RGBA pixels with a box filter: every destination pixel is
+     * the average of the source area it covers. The destination cannot be larger than the source.
+     */
+    static void downscale(const unsigned char* src, int srcWidth, int srcHeight, unsigned char* dst, int dstWidth, int dstHeight);
+};
+
+} // namespace brls
@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <borealis/core/time.hpp>
+
 namespace brls
 {
 
@@ -70,6 +72,7 @@ typedef struct ControllerState
 {
     bool buttons[_BUTTON_MAX]; // true: pressed
     float axes[_AXES_MAX]; // from 0.0f to 1.0f
+    Time timestamp; // when the state was sampled (see getCPUTimeUsec()), set by the main loop if left to 0
 } ControllerState;
 
 // Interface responsible for reporting input state to the application - button presses,
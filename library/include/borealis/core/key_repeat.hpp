@@ -0,0 +1,96 @@
+/*
+    Copyright 2021 natinusala
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#pragma once
+
+#include <borealis/core/input.hpp>
+#include <borealis/core/time.hpp>
+#include <vector>
+
+namespace brls
+{
+
+// How a held button repeats. All durations are in ms.
+struct KeyRepeatSettings
+{
+    bool enabled = true;
+
+    float delay    = 250.0f; // before the first repeat
+    float interval = 83.0f; // between repeats, at first
+
+    // The interval goes down linearly to the minimum interval
+    // over the acceleration time (0 disables acceleration)
+    float minimumInterval  = 83.0f;
+    float accelerationTime = 0.0f; // counted from the first repeat
+
+    // Once held for that long, every repeat counts as several presses,
+    // to go through long lists faster (0 disables page jumps)
+    float pageJumpDelay      = 0.0f; // counted from the first repeat
+    unsigned pageJumpPresses = 5;
+};
+
+// A press or repeat to handle this frame
+struct KeyPress
+{
+    enum ControllerButton button;
+    bool repeating;
+    unsigned count; // how many times to handle it (more than one when catching up or jumping pages)
+};
+
+// Turns the controller state into button presses and repeats, based on the time
+// the state was sampled. Like a keyboard, only the last pressed button repeats.
+//
+// Repeats that should have happened during a slow frame are not dropped: they are
+// all reported on the next frame (up to a limit, so that a long hitch doesn't
+// send the focus flying).
+class KeyRepeater
+{
+  public:
+    KeyRepeater();
+
+    void setSettings(enum ControllerButton button, KeyRepeatSettings settings);
+    KeyRepeatSettings getSettings(enum ControllerButton button);
+
+    /**
+     * Sets the maximum number of repeats reported at once after a slow frame.
+     */
+    void setMaximumCatchUp(unsigned repeats);
+
+    /**
+     * Called by the main loop with the state of the controller of the current frame.
+     * Returns the presses to handle, in order. The returned vector stays valid
+     * until the next update.
+     */
+    const std::vector<KeyPress>& update(const ControllerState& state);
+
+  private:
+    KeyRepeatSettings settings[_BUTTON_MAX];
+
+    bool pressed[_BUTTON_MAX] = {};
+
+    int repeatingButton = -1; // -1 if none
+    Time pressTime      = 0; // µs
+    float nextRepeat    = 0.0f; // ms, since the press
+    float firstRepeat   = 0.0f; // ms, since the press
+
+    unsigned maximumCatchUp = 10;
+
+    std::vector<KeyPress> presses;
+
+    float getInterval(const KeyRepeatSettings& settings, float repeatTime);
+};
+
+} // namespace brls
@@ -0,0 +1,161 @@
+/*
+    Copyright 2021 natinusala
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#pragma once
+
+#include <nanovg.h>
+
+#include <borealis/core/time.hpp>
+
+namespace brls
+{
+
+// Stages of the pipeline an input goes through before being visible on screen
+enum class LatencyStage
+{
+    INPUT_SAMPLED = 0, // controller state read by the main loop
+    ACTION_DISPATCHED, // actions, navigation and focus change done
+    LAYOUT_DONE, // animations and tickings updated, about to draw
+    FRAME_SUBMITTED, // every view drawn and the frame handed to the GPU
+    SWAP_RETURNED, // swap buffers returned, the frame is on its way to the display
+
+    _LATENCY_STAGE_MAX,
+};
+
+// Histogram of latencies, with 0.25ms wide buckets up to 100ms
+class LatencyHistogram
+{
+  public:
+    void record(Time latency);
+    void reset();
+
+    unsigned getCount();
+
+    /**
+     * Returns the latency under which the given proportion (between 0.0f and 1.0f)
+     * of the recorded latencies are, in ms. Latencies over 100ms are counted as 100ms.
+     */
+    float getPercentile(float percentile);
+
+    /**
+     * Returns the average latency, in ms.
+     */
+    float getAverage();
+
+    /**
+     * Returns the highest latency, in ms.
+     */
+    float getMaximum();
+
+  private:
+    static constexpr unsigned BUCKETS  = 400;
+    static constexpr Time BUCKET_WIDTH = 250; // µs
+
+    unsigned buckets[BUCKETS + 1] = {}; // last one is everything above
+
+    unsigned count = 0;
+    Time total     = 0;
+    Time maximum   = 0;
+};
+
+// Timestamps of one input, from the moment it was sampled (in µs, see getCPUTimeUsec())
+struct LatencyTrace
+{
+    Time timestamps[(int)LatencyStage::_LATENCY_STAGE_MAX] = {};
+
+    /**
+     * Returns the time between the input and the given stage, in ms.
+     */
+    float getLatency(LatencyStage stage) const;
+};
+
+// Measures the input-to-photon latency: the time between a button press being sampled
+// and the frame showing its result being swapped. The main loop opens a trace when a button
+// is pressed and timestamps every stage until the swap.
+// One trace is followed at a time: presses sampled in the same frame share it.
+//
+// Everything here must be called from the main thread.
+class LatencyTracer
+{
+  public:
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+
+    /**
+     * Called by the main loop when a button press is sampled, with the
+     * time of the sample. Does nothing if a trace is already open.
+     */
+    static void beginTrace(Time timestamp);
+
+    /**
+     * Timestamps the given stage of the current trace, if any.
+     * The trace is closed once the last stage is reached.
+     */
+    static void mark(LatencyStage stage);
+
+    /**
+     * Returns the histogram of the latencies between the input
+     * and the given stage (by default, the swap: the full latency).
+     */
+    static LatencyHistogram* getHistogram(LatencyStage stage = LatencyStage::SWAP_RETURNED);
+
+    /**
+     * Returns the last complete trace.
+     */
+    static const LatencyTrace& getLastTrace();
+
+    /**
+     * Resets every histogram.
+     */
+    static void reset();
+
+    /**
+     * Logs the latency percentiles every given interval, in ms.
+     * 0 (default) disables it.
+     */
+    static void setLogInterval(Time interval);
+
+    /**
+     * Enables or disables the latency readout in the top right corner of the screen.
+     */
+    static void setOverlayEnabled(bool enabled);
+
+    static bool isOverlayEnabled();
+
+    /**
+     * Called by the application at the end of each frame to draw the readout,
+     * in a content of the given width.
+     */
+    static void drawOverlay(NVGcontext* vg, int font, float width);
+
+  private:
+    static void finishTrace();
+    static void log();
+
+    inline static bool enabled        = true;
+    inline static bool overlayEnabled = false;
+    inline static bool tracing        = false;
+
+    inline static LatencyTrace currentTrace;
+    inline static LatencyTrace lastTrace;
+
+    inline static LatencyHistogram histograms[(int)LatencyStage::_LATENCY_STAGE_MAX];
+
+    inline static Time logInterval = 0; // ms
+    inline static Time lastLog     = 0; // µs
+};
+
+} // namespace brls
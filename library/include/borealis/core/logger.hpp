@@ -18,8 +18,34 @@
 #pragma once
 
 #include <fmt/core.h>
+#include <stdio.h>
 
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
+
+// Most verbose log level compiled in the binary (0 = error, 1 = warning, 2 = info, 3 = debug).
+// Log calls above that level are removed at compile time, arguments included.
+#ifndef BRLS_COMPILED_LOG_LEVEL
+#define BRLS_COMPILED_LOG_LEVEL 3
+#endif
+
+// Logging macros: unlike the Logger methods, they only evaluate their arguments
+// if the level is enabled, so they should be preferred when the arguments are costly
+// (like calling describe() on a view).
+#define BRLS_LOG(level, ...)                                                            \
+    do                                                                                  \
+    {                                                                                   \
+        if ((int)(level) <= BRLS_COMPILED_LOG_LEVEL && brls::Logger::isEnabled(level)) \
+            brls::Logger::log(level, __VA_ARGS__);                                      \
+    } while (0)
+
+#define BRLS_LOG_ERROR(...) BRLS_LOG(brls::LogLevel::ERROR, __VA_ARGS__)
+#define BRLS_LOG_WARNING(...) BRLS_LOG(brls::LogLevel::WARNING, __VA_ARGS__)
+#define BRLS_LOG_INFO(...) BRLS_LOG(brls::LogLevel::INFO, __VA_ARGS__)
+#define BRLS_LOG_DEBUG(...) BRLS_LOG(brls::LogLevel::DBG, __VA_ARGS__)
 
 namespace brls
 {
@@ -32,60 +58,151 @@ enum class LogLevel
     DBG
 };
 
+// A log sink receives every formatted log line, on the logger thread.
+class LogSink
+{
+  public:
+    virtual ~LogSink() {};
+
+    virtual void write(LogLevel level, const std::string& message) = 0;
+
+    /**
+     * Called when the logger thread has no more lines to write for now.
+     */
+    virtual void flush() {};
+};
+
+// Writes the logs to stdout, with colors
+class StdoutLogSink : public LogSink
+{
+  public:
+    void write(LogLevel level, const std::string& message) override;
+    void flush() override;
+};
+
+// Writes the logs to a file. Once the file exceeds the given size, it is renamed to
+// "<path>.1" (previous "<path>.1" becomes "<path>.2" and so on) and a new one is started.
+class RotatingFileLogSink : public LogSink
+{
+  public:
+    RotatingFileLogSink(std::string path, size_t maxSize = 1024 * 1024, unsigned maxFiles = 3);
+    ~RotatingFileLogSink();
+
+    void write(LogLevel level, const std::string& message) override;
+    void flush() override;
+
+  private:
+    void open();
+    void rotate();
+
+    std::string path;
+    size_t maxSize;
+    unsigned maxFiles;
+
+    FILE* file  = nullptr;
+    size_t size = 0;
+};
+
+// Keeps the last lines in memory, to be shown or dumped after a crash.
+class MemoryLogSink : public LogSink
+{
+  public:
+    MemoryLogSink(size_t capacity = 64);
+
+    void write(LogLevel level, const std::string& message) override;
+
+    /**
+     * Returns the last lines, oldest first. Can be called from any thread.
+     */
+    std::vector<std::string> getLines();
+
+  private:
+    std::mutex mutex;
+    std::vector<std::string> lines;
+    size_t capacity;
+    size_t next = 0;
+};
+
+// Logs are formatted on the calling thread then pushed to a lock-free ring buffer.
+// A background thread takes them from there and hands them to the sinks,
+// so that slow outputs (nxlink, files...) never block the UI.
 class Logger
 {
   public:
     static void setLogLevel(LogLevel logLevel);
 
+    /**
+     * Returns true if the given level is enabled, at compile time and at runtime.
+     */
+    inline static bool isEnabled(LogLevel level)
+    {
+        return (int)level <= BRLS_COMPILED_LOG_LEVEL && level <= Logger::logLevel;
+    }
+
+    /**
+     * Adds a sink that will receive every log line from now on.
+     * Stdout and memory sinks are always present.
+     */
+    static void addSink(std::shared_ptr<LogSink> sink);
+
+    /**
+     * Returns the in-memory sink keeping the last log lines.
+     */
+    static MemoryLogSink* getMemorySink();
+
+    /**
+     * Blocks until every pending log line is written to the sinks.
+     */
+    static void flush();
+
     template <typename... Args>
-    inline static void log(LogLevel logLevel, std::string prefix, std::string color, std::string format, Args&&... args)
+    inline static void log(LogLevel logLevel, fmt::string_view format, Args&&... args)
     {
-        if (Logger::logLevel < logLevel)
+        if (!Logger::isEnabled(logLevel))
             return;
 
+        std::string message;
+
         try
         {
-            fmt::print("\033{}[{}]\033[0m ", color, prefix);
-            fmt::print(format, args...);
-            fmt::print("\n");
+            message = fmt::format(format, std::forward<Args>(args)...);
         }
         catch (const std::exception& e)
         {
-            // will be printed after the first fmt::print (so after the log tag)
-            printf("! Invalid log format string: \"%s\": %s\n", format.c_str(), e.what());
+            message = fmt::format("! Invalid log format string: \"{}\": {}", format, e.what());
         }
 
-#ifdef __MINGW32__
-        fflush(0);
-#endif
+        Logger::push(logLevel, std::move(message));
     }
 
     template <typename... Args>
-    inline static void error(std::string format, Args&&... args)
+    inline static void error(fmt::string_view format, Args&&... args)
     {
-        Logger::log(LogLevel::ERROR, "ERROR", "[0;31m", format, args...);
+        Logger::log(LogLevel::ERROR, format, std::forward<Args>(args)...);
     }
 
     template <typename... Args>
-    inline static void warning(std::string format, Args&&... args)
+    inline static void warning(fmt::string_view format, Args&&... args)
     {
-        Logger::log(LogLevel::WARNING, "WARNING", "[0;33m", format, args...);
+        Logger::log(LogLevel::WARNING, format, std::forward<Args>(args)...);
     }
 
     template <typename... Args>
-    inline static void info(std::string format, Args&&... args)
+    inline static void info(fmt::string_view format, Args&&... args)
     {
-        Logger::log(LogLevel::INFO, "INFO", "[0;34m", format, args...);
+        Logger::log(LogLevel::INFO, format, std::forward<Args>(args)...);
     }
 
     template <typename... Args>
-    inline static void debug(std::string format, Args&&... args)
+    inline static void debug(fmt::string_view format, Args&&... args)
     {
-        Logger::log(LogLevel::DBG, "DEBUG", "[0;32m", format, args...);
+        Logger::log(LogLevel::DBG, format, std::forward<Args>(args)...);
     }
 
   private:
-    inline static LogLevel logLevel = LogLevel::INFO;
+    static void push(LogLevel level, std::string message);
+
+    inline static std::atomic<LogLevel> logLevel { LogLevel::INFO };
 };
 
 } // namespace brls
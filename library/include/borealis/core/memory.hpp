@@ -0,0 +1,130 @@
+/*
+    Copyright 2021 natinusala
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+#pragma once
+
+#include <nanovg.h>
+#include <tinyxml2.h>
+
+#include <borealis/core/time.hpp>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace brls
+{
+
+class View;
+
+// Snapshot of what the library holds in memory. Sizes are in bytes.
+struct MemoryReport
+{
+    size_t views = 0;
+    std::map<std::string, size_t> viewsByClass; // live instances per class name
+
+    size_t yogaNodes = 0;
+
+    // XML documents retained by the views they were inflated into
+    size_t xmlDocuments     = 0;
+    size_t xmlDocumentsSize = 0; // estimate, from their nodes and strings
+
+    // Textures owned by Image views (packed images are counted in the atlas)
+    size_t imageTextures     = 0;
+    size_t imageTexturesSize = 0;
+
+    size_t atlasSize       = 0;
+    size_t shadowCacheSize = 0;
+    size_t fontAtlasSize   = 0;
+
+    size_t themeEntries = 0;
+    size_t themeSize    = 0; // estimate
+
+    size_t runningTickings = 0;
+
+    size_t activities = 0;
+    size_t focusStack = 0; // views kept to give the focus back when popping activities
+
+    /**
+     * Returns the size of every texture: images, atlas, shadows and fonts.
+     */
+    size_t getTexturesSize() const;
+};
+
+// Keeps live counters of what the library holds in memory, to find out where it goes
+// and catch leaks (views or documents that are never deleted...).
+//
+// Views and Yoga nodes are counted as they are created and deleted, everything
+// else is gathered from its owner when a report is made.
+//
+// Everything here must be called from the main thread.
+class MemoryTracker
+{
+  public:
+    /**
+     * Called by every view when it's created and deleted. Views are linked
+     * together through their own pointers, so it doesn't allocate anything.
+     */
+    static void viewCreated(View* view);
+    static void viewDeleted(View* view);
+
+    static void yogaNodeCreated();
+    static void yogaNodeFreed();
+
+    static size_t getViewsCount();
+    static size_t getYogaNodesCount();
+
+    /**
+     * Gathers every counter. Goes through every live view,
+     * so it's not meant to be called every frame.
+     */
+    static MemoryReport getReport();
+
+    /**
+     * Logs a report, with the views count per class.
+     */
+    static void log();
+
+    /**
+     * Enables or disables the memory counters in the framerate display
+     * (see Application::setDisplayFramerate()).
+     */
+    static void setOverlayEnabled(bool enabled);
+
+    static bool isOverlayEnabled();
+
+    /**
+     * Returns the lines to draw in the framerate display. The report
+     * behind them is only made again every second.
+     */
+    static const std::vector<std::string>& getOverlayLines();
+
+    /**
+     * Returns an estimate of the memory used by the given XML document, in bytes.
+     */
+    static size_t getXMLDocumentSize(tinyxml2::XMLDocument* document);
+
+  private:
+    inline static View* firstView   = nullptr; // head of the live views list
+    inline static size_t viewsCount = 0;
+    inline static size_t yogaNodes  = 0;
+
+    inline static bool overlayEnabled = false;
+    inline static std::vector<std::string> overlayLines;
+    inline static Time overlayTime = 0; // µs
+};
+
+} // namespace brls
@@ -0,0 +1,97 @@
+/*
+    Copyright 2021 natinusala
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+#pragma once
+
+#include <nanovg.h>
+
+#include <vector>
+
+namespace brls
+{
+
+// The shadow around a rounded rectangle, as drawn by views: a box gradient
+// shifted down by width, clipped to the area around the rectangle
+// and with the rectangle itself cut out. An optional border can be drawn on top.
+struct ShadowStyle
+{
+    float cornerRadius = 0.0f; // of the rectangle, the gradient uses twice that
+    float width        = 0.0f;
+    float feather      = 0.0f;
+    float opacity      = 0.0f; // from 0 to 1, rendered in the texture
+    float offset       = 0.0f; // size of the area around the rectangle
+
+    float borderWidth    = 0.0f; // 0 for no border
+    NVGcolor borderColor = nvgRGBA(0, 0, 0, 0);
+
+    bool operator==(const ShadowStyle& other) const;
+};
+
+// Shadows are rendered once per style and scale in a small texture, then drawn as a
+// nine-patch: corners as they are, edges stretched. This is a lot cheaper than
+// tessellating and filling the gradient around every view on every frame.
+//
+// Everything here must be called from the main thread.
+class ShadowCache
+{
+  public:
+    /**
+     * Draws the shadow of the given rectangle with the given alpha, using the
+     * cached texture for the style (rendering it if needed). The alpha is applied
+     * when drawing the texture, and does not need a texture of its own.
+     *
+     * Returns false without drawing anything if the rectangle is too small to be sliced,
+     * the caller then has to draw the shadow itself.
+     */
+    static bool draw(NVGcontext* vg, const ShadowStyle& style, float x, float y, float width, float height, float alpha);
+
+    /**
+     * Deletes every cached texture.
+     */
+    static void clear(NVGcontext* vg);
+
+    /**
+     * Returns the memory used by the cached textures, in bytes.
+     */
+    static size_t getMemoryUsage();
+
+  private:
+    struct Entry
+    {
+        ShadowStyle style;
+        float scale;
+
+        int image;
+        int width, height; // px
+
+        // Margins, in px
+        int outsideX, outsideTop, outsideBottom; // around the rectangle
+        int inside; // inside the rectangle, where the corners are
+
+        unsigned lastUse;
+    };
+
+    static Entry* getEntry(NVGcontext* vg, const ShadowStyle& style, float scale);
+    static void render(NVGcontext* vg, Entry* entry);
+
+    static constexpr size_t MAX_ENTRIES = 32;
+
+    inline static std::vector<Entry> entries;
+    inline static unsigned useCounter = 0;
+};
+
+} // namespace brls
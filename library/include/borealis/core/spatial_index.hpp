@@ -0,0 +1,109 @@
+/*
+    Copyright 2021 natinusala
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace brls
+{
+
+class View;
+class Box;
+enum class FocusDirection;
+
+// Geometric index of the focusable views of a Box with spatial navigation enabled,
+// to find the next view to focus in a direction without traversing the tree.
+//
+// Views are put in a uniform grid by the center of their rect, relative to the Box
+// (so that scrolling the Box doesn't move them). The index is refreshed lazily,
+// on the first lookup after its tree was laid out: every focusable view of the Box
+// is collected again, and only the views that moved change cells.
+class SpatialIndex
+{
+  public:
+    SpatialIndex(Box* scope);
+    ~SpatialIndex();
+
+    SpatialIndex(const SpatialIndex&) = delete;
+    SpatialIndex& operator=(const SpatialIndex&) = delete;
+
+    /**
+     * Returns the best view to focus in the given direction, starting
+     * from the given view (which must be inside the Box), or nullptr if there is none.
+     */
+    View* getNextFocus(FocusDirection direction, View* currentView);
+
+    /**
+     * Marks the indexes the given tree can be part of as needing a refresh:
+     * the ones of the Boxes above it, and the ones inside of it.
+     * Called by the root of the tree after a layout pass.
+     */
+    static void invalidateTree(View* root);
+
+    /**
+     * Marks the indexes of the given view (if it's a Box) and of the Boxes above it as needing
+     * a refresh. Called when the view visibility or focusability changes, or when children are removed.
+     */
+    static void invalidateView(View* view);
+
+  private:
+    struct Rect
+    {
+        float x, y, width, height;
+    };
+
+    struct Entry
+    {
+        Rect rect;
+        int64_t cell;
+        unsigned seen;
+    };
+
+    Box* scope;
+
+    std::unordered_map<View*, Entry> entries;
+    std::unordered_map<int64_t, std::vector<View*>> cells;
+
+    float cellSize = 0.0f;
+    int minCellX = 0, minCellY = 0, maxCellX = -1, maxCellY = -1;
+
+    // Largest half size of the indexed views, to know how far
+    // from the center of its cell a view can reach
+    float maxHalfWidth = 0.0f, maxHalfHeight = 0.0f;
+
+    bool dirty         = true;
+    unsigned refreshes = 0;
+
+    std::vector<std::pair<View*, Rect>> collected;
+
+    // Every live index, there are only a few of them
+    inline static std::vector<SpatialIndex*> indexes;
+
+    void refresh();
+    void collect(View* view);
+
+    void insert(View* view, Rect rect);
+    void removeFromCell(View* view, int64_t cell);
+
+    Rect getRect(View* view);
+    void getCell(Rect rect, int* x, int* y);
+};
+
+} // namespace brls
@@ -0,0 +1,152 @@
+/*
+    Copyright 2021 natinusala
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+#pragma once
+
+#include <atomic>
+#include <borealis/core/time.hpp>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace brls
+{
+
+// Thread a startup step has to run on
+enum class StartupThread
+{
+    WORKER, // any thread, usually a worker of the task pool (file I/O, parsing...)
+    MAIN, // the main thread only (window, graphics context, anything using nanovg)
+};
+
+// One step of the application startup, see StartupGraph
+class StartupStep
+{
+  public:
+    const std::string& getName() const;
+    StartupThread getThread() const;
+
+    bool isDone() const;
+
+    /**
+     * Returns true if the step is done because it (or one of its dependencies) threw.
+     */
+    bool hasFailed() const;
+
+    /**
+     * Returns the time the step started and ended at, in µs
+     * since the beginning of the startup. 0 if it did not run yet.
+     */
+    Time getStartTime() const;
+    Time getEndTime() const;
+
+    /**
+     * Returns true if the step ended up running on the main thread.
+     * Worker steps can run on the main thread if it needs them before
+     * a worker got to them.
+     */
+    bool ranOnMainThread() const;
+
+  private:
+    friend class StartupGraph;
+
+    enum State
+    {
+        PENDING = 0,
+        RUNNING,
+        DONE,
+    };
+
+    std::string name;
+    StartupThread thread;
+    std::vector<StartupStep*> dependencies;
+    std::function<void()> run;
+
+    std::atomic<int> state { PENDING };
+    bool submitted = false; // protected by the graph mutex
+
+    Time startTime = 0;
+    Time endTime   = 0;
+    bool onMainThread = false;
+
+    std::exception_ptr exception; // set before the step is DONE
+};
+
+// Dependency graph of the steps run on startup. Worker steps are given to the task pool
+// as soon as their dependencies are done, so that file reads and parsing happen while
+// the main thread creates the window. Main steps run when the main thread waits for them,
+// or for anything depending on them.
+//
+// Steps can be added and waited for from any thread, but only the main thread runs main steps.
+class StartupGraph
+{
+  public:
+    /**
+     * Starts measuring the startup time. The thread calling it
+     * becomes the main thread of the graph.
+     */
+    void begin();
+
+    /**
+     * Adds a step to the graph, to be executed once every given dependency is done.
+     * Worker steps start right away if they can.
+     */
+    StartupStep* addStep(std::string name, StartupThread thread, std::vector<StartupStep*> dependencies, std::function<void()> run);
+
+    /**
+     * Blocks until the given step is done. Runs the step (and its dependencies) on
+     * the calling thread if nothing picked it up yet.
+     * Returns immediately if the step is nullptr or already done.
+     * Rethrows the exception of the step if it failed.
+     */
+    void wait(StartupStep* step);
+
+    /**
+     * Waits for every step of the graph, then logs the timing report.
+     * Rethrows the exception of the first failed step, if any.
+     * Must be called from the main thread.
+     */
+    void finish();
+
+    /**
+     * Logs how long each step took and on which thread,
+     * along with the total startup time.
+     */
+    void logReport();
+
+  private:
+    bool isReady(StartupStep* step);
+    bool tryRun(StartupStep* step);
+    void submitReadySteps();
+
+    std::mutex mutex;
+    std::condition_variable condition;
+
+    std::vector<std::unique_ptr<StartupStep>> steps;
+
+    std::thread::id mainThread;
+    Time beginTime    = 0;
+    Time endTime      = 0;
+    Time mainWaitTime = 0; // time the main thread spent blocked on steps running elsewhere
+};
+
+} // namespace brls
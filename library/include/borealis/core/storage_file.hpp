@@ -18,15 +18,21 @@
 
 #include <tinyxml2/tinyxml2.h>
 
+#include <borealis/core/binary_storage.hpp>
 #include <borealis/core/util.hpp>
 #include <borealis/core/logger.hpp>
+#include <borealis/core/timer.hpp>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace brls
 {
 
 #define BRLS_STORAGE_FILE_INIT(classname, filename, appname) classname() {this->init(filename, appname);}
+#define BRLS_STORAGE_FILE_INIT_BINARY_LISTS(classname, filename, appname) classname() {this->init(filename, appname, brls::StorageListBackend::BINARY);}
 
 #define BRLS_STORAGE_INT(var, name) brls::IntStorageObject var = brls::IntStorageObject(name, this)
 #define BRLS_STORAGE_FLOAT(var, name) brls::FloatStorageObject var = brls::FloatStorageObject(name, this)
@@ -40,6 +46,13 @@ namespace brls
 
 struct StorageFile;
 
+// Where the list properties of a storage file are stored
+enum class StorageListBackend
+{
+    XML, // in the XML file, with the other properties
+    BINARY, // in a separate binary file (see BinaryListFile), better suited to big lists
+};
+
 /**
  * A superclass for all StorageObject types.
  */
@@ -268,11 +281,19 @@ struct StringListStorageObject : public ListStorageObject<std::string>
 
 struct StorageFile
 {
+    ~StorageFile();
+
     /**
      * Initalizes the Storage File. Required in order to use
      * the Storage File.
+     *
+     * The file is read once here, then every property is kept in memory:
+     * reads never touch the disk, and writes only do when the file is flushed.
+     *
+     * With the binary list backend, list properties are stored in "<filename>.lists"
+     * instead, and written to the disk as soon as they are saved.
      */
-    bool init(std::string filename, std::string appname);
+    bool init(std::string filename, std::string appname, StorageListBackend listBackend = StorageListBackend::XML);
 
     /**
      * Writes a storage object to the storage file.
@@ -300,167 +321,110 @@ struct StorageFile
     template <typename T>
     bool readFromFile(std::string name, ListStorageObject<T> &object);
 
+    /**
+     * Writes every pending change to the disk, now and on the calling thread.
+     * The file is written to a temporary file first, then renamed, so that
+     * it's never left half written.
+     * Also called automatically when the storage file is destroyed.
+     */
+    bool flush();
+
+    /**
+     * Sets the write-behind delay, in ms. If greater than 0, saving an object
+     * only changes the file in memory, and every change made during the delay
+     * is written at once in the background when the delay expires.
+     *
+     * If 0 (default), every save is written to the disk immediately.
+     */
+    void setWriteBehindDelay(Time delay);
+
+    /**
+     * Returns true if there are changes not written to the disk yet.
+     */
+    bool isDirty();
+
     private:
+    struct Property
+    {
+        std::string element; // brls:<Type>Property or brls:<Type>ListProperty
+        std::string name;
+        std::string value;
+        std::vector<std::string> values;
+    };
+
+    // Shared with the background writes, which can outlive the storage file
+    struct WriteState
+    {
+        std::mutex mutex; // protects the fields below, never held during I/O
+        std::mutex fileMutex; // held by the thread writing the file
+        std::string content;
+        uint64_t sequence = 0; // sequence of content
+        uint64_t written  = 0; // sequence of the last content written to the disk
+    };
+
     bool inited = false;
     std::string config_path;
     std::string filename;
+
+    std::unordered_map<std::string, Property> properties; // by element + name
+    std::vector<std::string> order; // property keys, in file order
+    bool dirty = false;
+
+    Time writeBehindDelay = 0;
+    Timer writeBehindTimer;
+
+    std::shared_ptr<WriteState> writeState = std::make_shared<WriteState>();
+
+    StorageListBackend listBackend = StorageListBackend::XML;
+    BinaryListFile binaryLists;
+
+    bool load();
+
+    void setProperty(const std::string& element, const std::string& name, std::string value);
+    void setListProperty(const std::string& element, const std::string& name, std::vector<std::string> values);
+    Property* getProperty(const std::string& element, const std::string& name);
+
+    void onPropertyChanged();
+
+    std::string serialize();
+    void prepareWrite();
+    void flushInBackground();
+    static bool writeFile(std::string path, WriteState* state);
 };
 
 template <typename T>
 bool StorageFile::writeToFile(StorageObject<T> &object)
 {
-    const char *value = ConversionUtils::toCString(object.getValue());
-    std::string name = object.getName();
-
     if (!inited)
     {
         Logger::error("StorageFile with the filename {} has not been initalized yet.", this->filename);
         return false;
     }
 
-    tinyxml2::XMLDocument doc;
-    tinyxml2::XMLError errorCode = doc.LoadFile(config_path.c_str());
-
-    tinyxml2::XMLElement *root = doc.RootElement();
-    if (!root || errorCode == tinyxml2::XML_ERROR_EMPTY_DOCUMENT)
-    {
-        tinyxml2::XMLNode *pRoot = doc.NewElement("brls:StorageFile");
-        doc.InsertFirstChild(pRoot);
-
-        tinyxml2::XMLElement *element = doc.NewElement(("brls:" + object.getTypeName() + "Property").c_str());
-
-        element->SetAttribute("name", name.c_str());
-        element->SetAttribute("value", value);
-        pRoot->InsertEndChild(element);
-
-        errorCode = doc.SaveFile(config_path.c_str());
-
-        if (errorCode == tinyxml2::XML_SUCCESS || errorCode == tinyxml2::XML_ERROR_EMPTY_DOCUMENT)
-            return true;
-        else
-        {
-            Logger::error("TinyXML2 could not save the file. Error code {}.", std::to_string(errorCode));
-            Logger::error("More details: {}", doc.ErrorStr());
-            return false;
-        }
-    }
-    else if (errorCode == tinyxml2::XML_SUCCESS)
-    {
-        for (tinyxml2::XMLElement *e = root->FirstChildElement(); e != NULL; e = e->NextSiblingElement())
-        {
-            if (std::strcmp(e->Attribute("name"), name.c_str()) == 0)
-            {
-                root->DeleteChild(e);
-                break;
-            }
-        }
-
-        tinyxml2::XMLElement *element = doc.NewElement(("brls:" + object.getTypeName() + "Property").c_str());
-
-        element->SetAttribute("name", name.c_str());
-        element->SetAttribute("value", value);
-        root->InsertEndChild(element);
-
-        errorCode = doc.SaveFile(config_path.c_str());
-
-        if (errorCode == tinyxml2::XML_SUCCESS || errorCode == tinyxml2::XML_ERROR_EMPTY_DOCUMENT)
-            return true;
-        else
-        {
-            Logger::error("TinyXML2 could not save the file. Error code {}.", std::to_string(errorCode));
-            Logger::error("More details: {}", doc.ErrorStr());
-            return false;
-        }
-    }
-    
-    Logger::error("TinyXML2 could not open the file. Error code {}.", std::to_string(errorCode));
-    Logger::error("More details: {}", doc.ErrorStr());
-    return false;
+    this->setProperty("brls:" + object.getTypeName() + "Property", object.getName(), ConversionUtils::toString(object.getValue()));
+    return true;
 }
 
 template <typename T>
 bool StorageFile::writeToFile(ListStorageObject<T> &object)
 {
-    std::string name = object.getName();
-
     if (!inited)
     {
         Logger::error("StorageFile with the filename {} has not been initalized yet.", this->filename);
         return false;
     }
 
-    tinyxml2::XMLDocument doc;
-    tinyxml2::XMLError errorCode = doc.LoadFile(config_path.c_str());
+    if (this->listBackend == StorageListBackend::BINARY)
+        return this->binaryLists.write(object.getName(), object.getVector());
 
-    tinyxml2::XMLElement *root = doc.RootElement();
-    if (!root || errorCode == tinyxml2::XML_ERROR_EMPTY_DOCUMENT)
-    {
-        tinyxml2::XMLNode *pRoot = doc.NewElement("brls:StorageFile");
-        doc.InsertFirstChild(pRoot);
-
-        tinyxml2::XMLElement *element = doc.NewElement(("brls:" + object.getTypeName() + "ListProperty").c_str());
-
-        element->SetAttribute("name", name.c_str());
-
-        for (size_t i{0}; i < object.size(); i++)
-        {
-            tinyxml2::XMLElement *e = doc.NewElement("brls:Value");
-            e->SetAttribute("value", brls::ConversionUtils::toCString(object.getValue(i)));
-            element->InsertEndChild(e);
-        }
+    std::vector<std::string> values;
+    values.reserve(object.size());
 
-        pRoot->InsertEndChild(element);
+    for (size_t i{0}; i < object.size(); i++)
+        values.push_back(ConversionUtils::toString(object.getValue(i)));
 
-        errorCode = doc.SaveFile(config_path.c_str());
-
-        if (errorCode == tinyxml2::XML_SUCCESS || errorCode == tinyxml2::XML_ERROR_EMPTY_DOCUMENT)
-            return true;
-        else
-        {
-            Logger::error("TinyXML2 could not save the file. Error code {}.", std::to_string(errorCode));
-            Logger::error("More details: {}", doc.ErrorStr());
-            return false;
-        }
-    }
-    else if (errorCode == tinyxml2::XML_SUCCESS)
-    {
-        for (tinyxml2::XMLElement *e = root->FirstChildElement(("brls:" + object.getTypeName() + "ListProperty").c_str()); e != NULL; e = e->NextSiblingElement(("brls:" + object.getTypeName() + "ListProperty").c_str()))
-        {
-            if (std::strcmp(e->Attribute("name"), name.c_str()) == 0)
-            {
-                root->DeleteChild(e);
-                break;
-            }
-        }
-
-        tinyxml2::XMLElement *element = doc.NewElement(("brls:" + object.getTypeName() + "ListProperty").c_str());
-
-        element->SetAttribute("name", name.c_str());
-
-        for (size_t i{0}; i < object.size(); i++)
-        {
-            tinyxml2::XMLElement *e = doc.NewElement("brls:Value");
-            e->SetAttribute("value", brls::ConversionUtils::toCString(object.getValue(i)));
-            element->InsertEndChild(e);
-        }
-
-        root->InsertEndChild(element);
-
-        errorCode = doc.SaveFile(config_path.c_str());
-
-        if (errorCode == tinyxml2::XML_SUCCESS || errorCode == tinyxml2::XML_ERROR_EMPTY_DOCUMENT)
-            return true;
-        else
-        {
-            Logger::error("TinyXML2 could not save the file. Error code {}.", std::to_string(errorCode));
-            Logger::error("More details: {}", doc.ErrorStr());
-            return false;
-        }
-    }
-    
-    Logger::error("TinyXML2 could not open the file. Error code {}.", std::to_string(errorCode));
-    Logger::error("More details: {}", doc.ErrorStr());
-    return false;
+    this->setListProperty("brls:" + object.getTypeName() + "ListProperty", object.getName(), std::move(values));
+    return true;
 }
 
 template <typename T>
@@ -472,51 +436,18 @@ bool StorageFile::readFromFile(std::string name, StorageObject<T> &object)
         return false;
     }
 
-    tinyxml2::XMLDocument doc;
-    tinyxml2::XMLError errorCode = doc.LoadFile(config_path.c_str());
+    Property* property = this->getProperty("brls:" + object.getTypeName() + "Property", name);
 
-    if (errorCode == tinyxml2::XML_SUCCESS)
+    if (!property)
     {
-        tinyxml2::XMLElement *root = doc.RootElement();
-        if (root == nullptr)
-        {
-            Logger::error("StorageFile: NULL root element. This means the XML file is blank (hasn't been written to yet), or the XML file is broken.");
-            return false;
-        }
-
-        tinyxml2::XMLElement *element = nullptr;
-        for (tinyxml2::XMLElement *e = root->FirstChildElement(("brls:" + object.getTypeName() + "Property").c_str()); e != NULL; e = e->NextSiblingElement(("brls:" + object.getTypeName() + "Property").c_str()))
-        {
-            if (!e)
-                break;
-
-            if (std::strcmp(e->Attribute("name"), name.c_str()) == 0)
-            {
-                element = e;
-                break;
-            }
-        }
-
-        if (element)
-        {
-            const char *value;
-            element->QueryStringAttribute("value", &value);
+        Logger::error("StorageFile: Could not find property with the name {}.", name);
+        return false;
+    }
 
-            object.setName(name);
-            object.setValue(ConversionUtils::fromCString<T>(value));
+    object.setName(name);
+    object.setValue(ConversionUtils::fromString<T>(property->value));
 
-            return true;
-        }
-        else
-        {
-            Logger::error("StorageFile: Could not find property with the name {}.", name);
-            return false;
-        }
-    }
-    
-    Logger::error("TinyXML2 could not open the file. Error code {}.", std::to_string(errorCode));
-    Logger::error("More details: {}", doc.ErrorStr());
-    return false;
+    return true;
 }
 
 template <typename T>
@@ -530,53 +461,34 @@ bool StorageFile::readFromFile(std::string name, ListStorageObject<T> &object)
 
     object.getVector().clear();
 
-    tinyxml2::XMLDocument doc;
-    tinyxml2::XMLError errorCode = doc.LoadFile(config_path.c_str());
-
-    if (errorCode == tinyxml2::XML_SUCCESS)
+    if (this->listBackend == StorageListBackend::BINARY)
     {
-        tinyxml2::XMLElement *root = doc.RootElement();
-        if (root == nullptr)
+        if (!this->binaryLists.read(name, object.getVector()))
         {
-            Logger::error("StorageFile: NULL root element. This means the XML file is blank (hasn't been written to yet), or the XML file is broken.");
+            Logger::error("StorageFile: Could not find list property with the name {}.", name);
             return false;
         }
 
-        tinyxml2::XMLElement *element = nullptr;
-        for (tinyxml2::XMLElement *e = root->FirstChildElement(("brls:" + object.getTypeName() + "ListProperty").c_str()); e != NULL; e = e->NextSiblingElement(("brls:" + object.getTypeName() + "ListProperty").c_str()))
-        {
-            if (!e)
-                break;
-
-            if (std::strcmp(e->Attribute("name"), name.c_str()) == 0)
-            {
-                element = e;
-                break;
-            }
-        }
+        object.setName(name);
+        return true;
+    }
 
-        if (element)
-        {   
-           for (tinyxml2::XMLElement *e = element->FirstChildElement("brls:Value"); e != NULL; e = e->NextSiblingElement("brls:Value"))
-           {
-               const char *attributeEle;
-               e->QueryStringAttribute("value", &attributeEle);
-               object.pushValue(brls::ConversionUtils::fromCString<T>(attributeEle));
-           }
-            object.setName(name);
-
-            return true;
-        }
-        else
-        {
-            Logger::error("StorageFile: Could not find property with the name {}.", name);
-            return false;
-        }
+    Property* property = this->getProperty("brls:" + object.getTypeName() + "ListProperty", name);
+
+    if (!property)
+    {
+        Logger::error("StorageFile: Could not find property with the name {}.", name);
+        return false;
     }
-    
-    Logger::error("TinyXML2 could not open the file. Error code {}.", std::to_string(errorCode));
-    Logger::error("More details: {}", doc.ErrorStr());
-    return false;
+
+    object.getVector().reserve(property->values.size());
+
+    for (const std::string& value : property->values)
+        object.pushValue(ConversionUtils::fromString<T>(value));
+
+    object.setName(name);
+
+    return true;
 }
 
 template <typename T>
@@ -53,6 +53,10 @@ struct Theme
 
     void getAllMetricKeys(const std::string prefix);
 
+    // Number of colors and metrics, and an estimate of the memory they use (in bytes)
+    size_t getEntriesCount();
+    size_t getMemoryUsage();
+
     private:
     // Each color/metric has a key of their theme variant + prefix
     // An example: "dark/brls/sidebar/background"
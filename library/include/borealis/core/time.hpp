@@ -29,6 +29,7 @@ typedef retro_time_t Time;
 
 /**
  * Returns the current CPU time in microseconds.
+ * The clock is monotonic.
  */
 inline Time getCPUTimeUsec()
 {
@@ -85,22 +86,34 @@ class Ticking
 
     /**
      * Called internally by the main loop. Takes all running tickings
-     * and updates them.
+     * and updates them with the given delta, in ms.
      */
-    static void updateTickings();
+    static void updateTickings(float delta);
+
+    /**
+     * Returns the interpolation factor to use when rendering
+     * values updated with a fixed timestep, between 0.0f and 1.0f.
+     * Always 1.0f if fixed timestep is disabled.
+     */
+    static float getInterpolationAlpha();
+
+    /**
+     * Called internally by the main loop after running the fixed steps.
+     */
+    static void setInterpolationAlpha(float alpha);
 
     inline static std::vector<Ticking*> runningTickings;
 
   protected:
     /**
      * Executed every frame while the ticking lives.
-     * Delta is the time difference in ms between the last frame
-     * and the current one.
+     * Delta is the time difference in ms between the last update
+     * and the current one. It is not rounded, so it can be fractional.
      * Must return false if the ticking is finished and should be
      * removed from the list of active tickings.
      * The end callback will automatically be called then.
      */
-    virtual bool onUpdate(Time delta) = 0;
+    virtual bool onUpdate(float delta) = 0;
 
     /**
      * Called when the ticking becomes active.
@@ -116,6 +129,8 @@ class Ticking
   private:
     void stop(bool finished);
 
+    inline static float interpolationAlpha = 1.0f;
+
     bool running = false;
 
     TickingEndCallback endCallback   = [](bool finished) {};
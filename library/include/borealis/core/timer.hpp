@@ -43,13 +43,13 @@ class Timer : public FiniteTicking
     void setDuration(Time duration);
 
     void onStart() override;
-    bool onUpdate(Time delta) override;
+    bool onUpdate(float delta) override;
     void onReset() override;
     void onRewind() override;
 
   protected:
-    Time duration = 0;
-    Time progress = 0;
+    Time duration  = 0;
+    float progress = 0.0f;
 };
 
 // A RepeatingTimer allows to run a callback repeatedly at a given time interval, in ms
@@ -81,11 +81,11 @@ class RepeatingTimer : public Ticking
     void setCallback(TickingGenericCallback callback);
 
     void onStart() override;
-    bool onUpdate(Time delta) override;
+    bool onUpdate(float delta) override;
 
   protected:
-    Time period   = 0;
-    Time progress = 0;
+    Time period    = 0;
+    float progress = 0.0f;
 
     TickingGenericCallback callback = [] {};
 };
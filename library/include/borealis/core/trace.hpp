@@ -0,0 +1,139 @@
+/*
+    Copyright 2021 natinusala
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+#pragma once
+
+#include <borealis/core/time.hpp>
+#include <string>
+
+// Compiles the tracing scopes in when set to 1. When 0, BRLS_TRACE_SCOPE and
+// BRLS_TRACE_THREAD_NAME expand to nothing and the Tracer records nothing.
+#ifndef BRLS_TRACING
+#define BRLS_TRACING 0
+#endif
+
+#define BRLS_TRACE_CONCAT_INNER(a, b) a##b
+#define BRLS_TRACE_CONCAT(a, b) BRLS_TRACE_CONCAT_INNER(a, b)
+
+#if BRLS_TRACING
+// Records the time spent in the enclosing scope under the given name.
+// The name must be a string literal (or live for as long as the program).
+#define BRLS_TRACE_SCOPE(name) brls::TraceScope BRLS_TRACE_CONCAT(brlsTraceScope, __LINE__)(name)
+
+// Names the calling thread in the exported trace. Same lifetime rule as above.
+#define BRLS_TRACE_THREAD_NAME(name) brls::Tracer::setThreadName(name)
+#else
+#define BRLS_TRACE_SCOPE(name) \
+    do                         \
+    {                          \
+    } while (0)
+
+#define BRLS_TRACE_THREAD_NAME(name) \
+    do                               \
+    {                                \
+    } while (0)
+#endif
+
+namespace brls
+{
+
+// A complete trace event: a named scope with its start and duration
+struct TraceEvent
+{
+    const char* name;
+    Time start; // µs, see getCPUTimeUsec()
+    Time duration; // µs
+};
+
+// Records the scopes opened with BRLS_TRACE_SCOPE and exports them in the Chrome
+// trace event format (JSON), to be opened in chrome://tracing or Perfetto.
+//
+// Every thread records in its own ring buffer without taking any lock, the oldest
+// events are overwritten when a buffer is full. Only the exporting takes a lock.
+class Tracer
+{
+  public:
+    /**
+     * Events kept per thread, older ones are dropped.
+     */
+    static constexpr size_t BUFFER_CAPACITY = 1 << 14;
+
+    /**
+     * Records an event in the buffer of the calling thread.
+     */
+    static void record(const char* name, Time start, Time duration);
+
+    /**
+     * Names the calling thread in the exported trace.
+     */
+    static void setThreadName(const char* name);
+
+    /**
+     * Writes every recorded event to the given file, as Chrome trace JSON.
+     * Can be called from any thread, events still being recorded while
+     * exporting may be missing. Returns false if the file could not be written.
+     */
+    static bool exportJSON(const std::string& path);
+
+    /**
+     * Sets a file to export the trace to when the application exits.
+     * Empty (the default) to disable.
+     */
+    static void setExportOnExit(const std::string& path);
+
+    /**
+     * Called by the application on exit.
+     */
+    static void exportOnExit();
+
+    /**
+     * Returns true if tracing is compiled in.
+     */
+    static constexpr bool isCompiledIn()
+    {
+        return BRLS_TRACING;
+    }
+
+  private:
+    inline static std::string exitPath;
+};
+
+// Scope guard recording the time between its construction and
+// its destruction, use BRLS_TRACE_SCOPE instead of using it directly
+class TraceScope
+{
+  public:
+    TraceScope(const char* name)
+        : name(name)
+        , start(getCPUTimeUsec())
+    {
+    }
+
+    ~TraceScope()
+    {
+        Tracer::record(this->name, this->start, getCPUTimeUsec() - this->start);
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+  private:
+    const char* name;
+    Time start;
+};
+
+} // namespace brls
@@ -17,9 +17,15 @@
 
 #pragma once
 
+#include <stdlib.h>
+
 #include <borealis/core/logger.hpp>
+#include <charconv>
 #include <sstream>
 #include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
 
 namespace brls
 {
@@ -30,19 +36,54 @@ namespace brls
 [[noreturn]] void fatal(std::string message);
 
 struct ConversionUtils
-{ 
+{
     /*
-     * Converts any primitive type to a C-style string (char*)
+     * Converts any primitive type to a string
      */
     template <typename T>
-    inline static char* toCString(const T& t)
+    inline static std::string toString(const T& t)
     {
-        std::ostringstream oss;
-        oss << std::boolalpha << t;
+        return fmt::format("{}", t);
+    }
 
-        char* output = new char[sizeof(oss.str().c_str()) + 1];
-        std::strcpy(output, oss.str().c_str());
-        return output;
+    /*
+     * Converts a string to any primitive type, without allocating
+     */
+    template <typename T>
+    inline static T fromString(std::string_view s)
+    {
+        if constexpr (std::is_same_v<T, std::string>)
+        {
+            return std::string(s);
+        }
+        else if constexpr (std::is_same_v<T, bool>)
+        {
+            return s == "true" || s == "1";
+        }
+        else if constexpr (std::is_integral_v<T>)
+        {
+            T t = 0;
+            std::from_chars(s.data(), s.data() + s.size(), t);
+            return t;
+        }
+        else if constexpr (std::is_floating_point_v<T>)
+        {
+#if defined(__cpp_lib_to_chars)
+            T t = 0;
+            std::from_chars(s.data(), s.data() + s.size(), t);
+            return t;
+#else
+            // No floating point from_chars in this standard library
+            return (T)strtod(std::string(s).c_str(), nullptr);
+#endif
+        }
+        else
+        {
+            std::istringstream iss((std::string(s)));
+            T t;
+            iss >> t;
+            return t;
+        }
     }
 
     /*
@@ -51,10 +92,7 @@ struct ConversionUtils
     template <typename T>
     inline static T fromCString(const char* s)
     {
-        std::istringstream iss((std::string(s)));
-        T t;
-        iss >> std::boolalpha >> t;
-        return t;
+        return fromString<T>(s ? std::string_view(s) : std::string_view());
     }
 };
 
@@ -50,5 +50,17 @@ class VideoContext
      */
     virtual void resetState() = 0;
 
+    /**
+     * Enables or disables vsync. If enabled, endFrame() must
+     * block until the frame is presented.
+     */
+    virtual void setVSync(bool enabled) = 0;
+
+    /**
+     * Returns the refresh rate of the display the app
+     * is currently presented on, in Hz.
+     */
+    virtual float getDisplayRefreshRate() = 0;
+
     virtual NVGcontext* getNVGContext() = 0;
 };
@@ -25,9 +25,12 @@
 
 #include <borealis/core/actions.hpp>
 #include <borealis/core/animation.hpp>
+#include <borealis/core/async.hpp>
 #include <borealis/core/event.hpp>
 #include <borealis/core/frame_context.hpp>
+#include <borealis/core/spatial_index.hpp>
 #include <borealis/core/util.hpp>
+#include <borealis/core/view_index.hpp>
 #include <functional>
 #include <memory>
 #include <set>
@@ -202,11 +205,7 @@ class View
 
     std::vector<Action> actions;
 
-    /**
-     * Parent user data, typically the index of the view
-     * in the internal layout structure
-     */
-    void* parentUserdata = nullptr;
+    size_t parentIndex = 0; // index of the view in the children of its parent
 
     bool culled = true; // will be culled by the parent Box, if any
 
@@ -246,6 +245,14 @@ class View
     std::unordered_map<FocusDirection, std::string> customFocusById;
     std::unordered_map<FocusDirection, View*> customFocusByPtr;
 
+    CancellationSource lifetime;
+
+    // Intrusive list of every live view, see MemoryTracker
+    View* previousLiveView = nullptr;
+    View* nextLiveView     = nullptr;
+
+    friend class MemoryTracker;
+
   protected:
     Animatable collapseState = 1.0f;
 
@@ -257,7 +264,22 @@ class View
 
     YGNode* ygNode;
 
-    std::string id = "";
+    std::string id                = "";
+    const std::string* internedId = nullptr;
+
+    /**
+     * Returns the ID index of the tree this view is in, kept by the root of the tree.
+     * If create is false, returns nullptr if the tree doesn't have one yet.
+     */
+    ViewIndex* getTreeViewIndex(bool create);
+
+    /**
+     * Returns the ID index kept by this view, used if it's the root of its tree.
+     */
+    virtual ViewIndex* getViewIndex(bool create)
+    {
+        return nullptr;
+    }
 
     // Helper functions to apply this view's alpha to a color
     NVGcolor a(NVGcolor color);
@@ -298,6 +320,20 @@ class View
     View();
     virtual ~View();
 
+    /**
+     * Views created while an arena scope is open are allocated
+     * in its arena, the others on the heap (see Arena).
+     */
+    static void* operator new(size_t size);
+    static void operator delete(void* memory);
+
+    /**
+     * Returns a token that gets cancelled when the view is deleted.
+     * Give it to brls::sync() to safely update the view once
+     * a background task is done.
+     */
+    CancellationToken getLifetimeToken();
+
     void setBackground(ViewBackground background);
 
     void shakeHighlight(FocusDirection direction);
@@ -606,6 +642,17 @@ class View
      */
     void setId(std::string id);
 
+    /**
+     * Returns the interned id of the view (see ViewIndex), or nullptr if it has none.
+     */
+    const std::string* getInternedId();
+
+    /**
+     * Returns true if this view is a child of the given view,
+     * directly or not.
+     */
+    bool isChildOf(View* ancestor);
+
     /**
      * Overrides align items of the parent box.
      *
@@ -761,8 +808,8 @@ class View
      * been found. "Nearest" means the closest in the vicinity
      * of this view. The siblings are searched as well as its children.
      *
-     * Research is done by traversing the tree upwards, starting from this view.
-     * The current algorithm is very inefficient.
+     * Research is done by looking up the ID in the index of the tree, then
+     * keeping the view in the closest scope, going upwards from this view.
      */
     virtual View* getNearestView(std::string id);
 
@@ -910,6 +957,8 @@ class View
      */
     void bindXMLDocument(tinyxml2::XMLDocument* document);
 
+    const std::vector<tinyxml2::XMLDocument*>& getBoundXMLDocuments();
+
     /**
      * Returns if the given XML attribute name is valid for that view.
      */
@@ -937,6 +986,7 @@ class View
     inline void setFocusable(bool focusable)
     {
         this->focusable = focusable;
+        SpatialIndex::invalidateView(this);
     }
 
     bool isFocusable();
@@ -970,11 +1020,18 @@ class View
      */
     void setDetachedPosition(float x, float y);
 
-    void setParent(Box* parent, void* parentUserdata = nullptr);
+    /**
+     * Called by the parent Box when the view is added, and when its
+     * index changes (siblings added or removed before it).
+     */
+    void setParent(Box* parent, size_t index = 0);
     Box* getParent();
     bool hasParent();
 
-    void* getParentUserData();
+    /**
+     * Returns the index of the view in the children of its parent.
+     */
+    size_t getIndexInParent();
 
     /**
      * Registers an action with the given parameters. The listener will be fired when the user presses
@@ -0,0 +1,67 @@
+/*
+    Copyright 2021 natinusala
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace brls
+{
+
+class View;
+
+// Index of the views of a tree by ID, kept by the root Box of the tree and updated
+// as IDs are set and views are added and removed. IDs are interned: every view
+// with the same ID points to the same string, so the index is keyed by pointer.
+class ViewIndex
+{
+  public:
+    /**
+     * Returns the interned string of the given ID, interning it if needed.
+     */
+    static const std::string* intern(const std::string& id);
+
+    /**
+     * Returns the interned string of the given ID, or nullptr if
+     * no view ever had that ID.
+     */
+    static const std::string* getInterned(const std::string& id);
+
+    void add(View* view);
+    void remove(View* view);
+
+    /**
+     * Moves every view of the given index into this one.
+     */
+    void merge(ViewIndex* other);
+
+    /**
+     * Returns every view of the tree with the given ID, in no particular order.
+     */
+    const std::vector<View*>& find(const std::string* id);
+
+  private:
+    std::unordered_map<const std::string*, std::vector<View*>> views;
+
+    inline static std::unordered_set<std::string> ids;
+    inline static std::mutex idsMutex;
+};
+
+} // namespace brls
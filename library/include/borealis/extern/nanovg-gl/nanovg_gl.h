@@ -117,6 +117,7 @@ enum GLNVGuniformLoc {
 	GLNVG_LOC_VIEWSIZE,
 	GLNVG_LOC_TEX,
 	GLNVG_LOC_FRAG,
+	GLNVG_LOC_FRAGBASE,
 	GLNVG_MAX_LOCS
 };
 
@@ -188,43 +189,29 @@ struct GLNVGpath {
 typedef struct GLNVGpath GLNVGpath;
 
 struct GLNVGfragUniforms {
-	#if NANOVG_GL_USE_UNIFORMBUFFER
-		float scissorMat[12]; // matrices are actually 3 vec4s
-		float paintMat[12];
-		struct NVGcolor innerCol;
-		struct NVGcolor outerCol;
-		float scissorExt[2];
-		float scissorScale[2];
-		float extent[2];
-		float radius;
-		float feather;
-		float strokeMult;
-		float strokeThr;
-		int texType;
-		int type;
-	#else
-		// note: after modifying layout or size of uniform array,
-		// don't forget to also update the fragment shader source!
-		#define NANOVG_GL_UNIFORMARRAY_SIZE 11
-		union {
-			struct {
-				float scissorMat[12]; // matrices are actually 3 vec4s
-				float paintMat[12];
-				struct NVGcolor innerCol;
-				struct NVGcolor outerCol;
-				float scissorExt[2];
-				float scissorScale[2];
-				float extent[2];
-				float radius;
-				float feather;
-				float strokeMult;
-				float strokeThr;
-				float texType;
-				float type;
-			};
-			float uniformArray[NANOVG_GL_UNIFORMARRAY_SIZE][4];
+	// note: after modifying layout or size of uniform array,
+	// don't forget to also update the fragment shader source!
+	// The uniform buffer uses the same layout: it is read as an array of vec4s,
+	// so that one buffer range can hold the uniforms of several merged calls.
+	#define NANOVG_GL_UNIFORMARRAY_SIZE 11
+	union {
+		struct {
+			float scissorMat[12]; // matrices are actually 3 vec4s
+			float paintMat[12];
+			struct NVGcolor innerCol;
+			struct NVGcolor outerCol;
+			float scissorExt[2];
+			float scissorScale[2];
+			float extent[2];
+			float radius;
+			float feather;
+			float strokeMult;
+			float strokeThr;
+			float texType;
+			float type;
 		};
-	#endif
+		float uniformArray[NANOVG_GL_UNIFORMARRAY_SIZE][4];
+	};
 };
 typedef struct GLNVGfragUniforms GLNVGfragUniforms;
 
@@ -241,6 +228,10 @@ struct GLNVGcontext {
 #endif
 #if NANOVG_GL_USE_UNIFORMBUFFER
 	GLuint fragBuf;
+	GLuint vertFragBuf;
+	int fragCount; // number of uniform structs visible from one bound range
+	int vertFragsEnabled;
+	int fragBase;
 #endif
 	int fragSize;
 	int flags;
@@ -255,6 +246,9 @@ struct GLNVGcontext {
 	struct NVGvertex* verts;
 	int cverts;
 	int nverts;
+#if NANOVG_GL_USE_UNIFORMBUFFER
+	int* vertFrags; // index of the uniform struct of each vertex
+#endif
 	unsigned char* uniforms;
 	int cuniforms;
 	int nuniforms;
@@ -463,6 +457,7 @@ static int glnvg__createShader(GLNVGshader* shader, const char* name, const char
 
 	glBindAttribLocation(prog, 0, "vertex");
 	glBindAttribLocation(prog, 1, "tcoord");
+	glBindAttribLocation(prog, 2, "fragIndex");
 
 	glLinkProgram(prog);
 	glGetProgramiv(prog, GL_LINK_STATUS, &status);
@@ -495,6 +490,7 @@ static void glnvg__getUniforms(GLNVGshader* shader)
 
 #if NANOVG_GL_USE_UNIFORMBUFFER
 	shader->loc[GLNVG_LOC_FRAG] = glGetUniformBlockIndex(shader->prog, "frag");
+	shader->loc[GLNVG_LOC_FRAGBASE] = glGetUniformLocation(shader->prog, "fragBase");
 #else
 	shader->loc[GLNVG_LOC_FRAG] = glGetUniformLocation(shader->prog, "frag");
 #endif
@@ -504,6 +500,12 @@ static int glnvg__renderCreate(void* uptr)
 {
 	GLNVGcontext* gl = (GLNVGcontext*)uptr;
 	int align = 4;
+#if NANOVG_GL_USE_UNIFORMBUFFER
+	int blockSize = 0;
+	char header[256];
+#else
+	const char* header;
+#endif
 
 	// TODO: mediump float may not be enough for GLES2 in iOS.
 	// see the following discussion: https://github.com/memononen/nanovg/issues/46
@@ -535,6 +537,11 @@ static int glnvg__renderCreate(void* uptr)
 		"	in vec2 tcoord;\n"
 		"	out vec2 ftcoord;\n"
 		"	out vec2 fpos;\n"
+		"#ifdef USE_UNIFORMBUFFER\n"
+		"	uniform int fragBase;\n"
+		"	in int fragIndex;\n"
+		"	flat out int ffrag;\n"
+		"#endif\n"
 		"#else\n"
 		"	uniform vec2 viewSize;\n"
 		"	attribute vec2 vertex;\n"
@@ -545,6 +552,9 @@ static int glnvg__renderCreate(void* uptr)
 		"void main(void) {\n"
 		"	ftcoord = tcoord;\n"
 		"	fpos = vertex;\n"
+		"#ifdef USE_UNIFORMBUFFER\n"
+		"	ffrag = fragIndex - fragBase;\n"
+		"#endif\n"
 		"	gl_Position = vec4(2.0*vertex.x/viewSize.x - 1.0, 1.0 - 2.0*vertex.y/viewSize.y, 0, 1);\n"
 		"}\n";
 
@@ -559,22 +569,13 @@ static int glnvg__renderCreate(void* uptr)
 		"#ifdef NANOVG_GL3\n"
 		"#ifdef USE_UNIFORMBUFFER\n"
 		"	layout(std140) uniform frag {\n"
-		"		mat3 scissorMat;\n"
-		"		mat3 paintMat;\n"
-		"		vec4 innerCol;\n"
-		"		vec4 outerCol;\n"
-		"		vec2 scissorExt;\n"
-		"		vec2 scissorScale;\n"
-		"		vec2 extent;\n"
-		"		float radius;\n"
-		"		float feather;\n"
-		"		float strokeMult;\n"
-		"		float strokeThr;\n"
-		"		int texType;\n"
-		"		int type;\n"
+		"		vec4 frags[FRAG_COUNT * FRAG_STRIDE];\n"
 		"	};\n"
+		"	flat in int ffrag;\n"
+		"	#define FRAG(i) frags[ffrag * FRAG_STRIDE + i]\n"
 		"#else\n" // NANOVG_GL3 && !USE_UNIFORMBUFFER
 		"	uniform vec4 frag[UNIFORMARRAY_SIZE];\n"
+		"	#define FRAG(i) frag[i]\n"
 		"#endif\n"
 		"	uniform sampler2D tex;\n"
 		"	in vec2 ftcoord;\n"
@@ -582,25 +583,24 @@ static int glnvg__renderCreate(void* uptr)
 		"	out vec4 outColor;\n"
 		"#else\n" // !NANOVG_GL3
 		"	uniform vec4 frag[UNIFORMARRAY_SIZE];\n"
+		"	#define FRAG(i) frag[i]\n"
 		"	uniform sampler2D tex;\n"
 		"	varying vec2 ftcoord;\n"
 		"	varying vec2 fpos;\n"
 		"#endif\n"
-		"#ifndef USE_UNIFORMBUFFER\n"
-		"	#define scissorMat mat3(frag[0].xyz, frag[1].xyz, frag[2].xyz)\n"
-		"	#define paintMat mat3(frag[3].xyz, frag[4].xyz, frag[5].xyz)\n"
-		"	#define innerCol frag[6]\n"
-		"	#define outerCol frag[7]\n"
-		"	#define scissorExt frag[8].xy\n"
-		"	#define scissorScale frag[8].zw\n"
-		"	#define extent frag[9].xy\n"
-		"	#define radius frag[9].z\n"
-		"	#define feather frag[9].w\n"
-		"	#define strokeMult frag[10].x\n"
-		"	#define strokeThr frag[10].y\n"
-		"	#define texType int(frag[10].z)\n"
-		"	#define type int(frag[10].w)\n"
-		"#endif\n"
+		"	#define scissorMat mat3(FRAG(0).xyz, FRAG(1).xyz, FRAG(2).xyz)\n"
+		"	#define paintMat mat3(FRAG(3).xyz, FRAG(4).xyz, FRAG(5).xyz)\n"
+		"	#define innerCol FRAG(6)\n"
+		"	#define outerCol FRAG(7)\n"
+		"	#define scissorExt FRAG(8).xy\n"
+		"	#define scissorScale FRAG(8).zw\n"
+		"	#define extent FRAG(9).xy\n"
+		"	#define radius FRAG(9).z\n"
+		"	#define feather FRAG(9).w\n"
+		"	#define strokeMult FRAG(10).x\n"
+		"	#define strokeThr FRAG(10).y\n"
+		"	#define texType int(FRAG(10).z)\n"
+		"	#define type int(FRAG(10).w)\n"
 		"\n"
 		"float sdroundrect(vec2 pt, vec2 ext, float rad) {\n"
 		"	vec2 ext2 = ext - vec2(rad,rad);\n"
@@ -675,11 +675,31 @@ static int glnvg__renderCreate(void* uptr)
 
 	glnvg__checkError(gl, "init");
 
+#if NANOVG_GL_USE_UNIFORMBUFFER
+	// The uniform structs must be aligned for glBindBufferRange() and be a whole
+	// number of vec4s to be indexed by the shader
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &align);
+	if (align < 1) align = 1;
+	gl->fragSize = (sizeof(GLNVGfragUniforms) + align - 1) / align * align;
+	while (gl->fragSize % 16 != 0)
+		gl->fragSize += align;
+
+	// Merged calls must fit in one bound range
+	glGetIntegerv(GL_MAX_UNIFORM_BLOCK_SIZE, &blockSize);
+	if (blockSize > 65536) blockSize = 65536;
+	gl->fragCount = glnvg__maxi(blockSize / gl->fragSize, 1);
+
+	snprintf(header, sizeof(header), "%s#define FRAG_STRIDE %d\n#define FRAG_COUNT %d\n",
+		shaderHeader, gl->fragSize / 16, gl->fragCount);
+#else
+	header = shaderHeader;
+#endif
+
 	if (gl->flags & NVG_ANTIALIAS) {
-		if (glnvg__createShader(&gl->shader, "shader", shaderHeader, "#define EDGE_AA 1\n", fillVertShader, fillFragShader) == 0)
+		if (glnvg__createShader(&gl->shader, "shader", header, "#define EDGE_AA 1\n", fillVertShader, fillFragShader) == 0)
 			return 0;
 	} else {
-		if (glnvg__createShader(&gl->shader, "shader", shaderHeader, NULL, fillVertShader, fillFragShader) == 0)
+		if (glnvg__createShader(&gl->shader, "shader", header, NULL, fillVertShader, fillFragShader) == 0)
 			return 0;
 	}
 
@@ -696,9 +716,10 @@ static int glnvg__renderCreate(void* uptr)
 	// Create UBOs
 	glUniformBlockBinding(gl->shader.prog, gl->shader.loc[GLNVG_LOC_FRAG], GLNVG_FRAG_BINDING);
 	glGenBuffers(1, &gl->fragBuf);
-	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &align);
-#endif
+	glGenBuffers(1, &gl->vertFragBuf);
+#else
 	gl->fragSize = sizeof(GLNVGfragUniforms) + align - sizeof(GLNVGfragUniforms) % align;
+#endif
 
 	glnvg__checkError(gl, "create done");
 
@@ -945,17 +966,10 @@ static int glnvg__convertPaint(GLNVGcontext* gl, GLNVGfragUniforms* frag, NVGpai
 		}
 		frag->type = NSVG_SHADER_FILLIMG;
 
-		#if NANOVG_GL_USE_UNIFORMBUFFER
-		if (tex->type == NVG_TEXTURE_RGBA)
-			frag->texType = (tex->flags & NVG_IMAGE_PREMULTIPLIED) ? 0 : 1;
-		else
-			frag->texType = 2;
-		#else
 		if (tex->type == NVG_TEXTURE_RGBA)
 			frag->texType = (tex->flags & NVG_IMAGE_PREMULTIPLIED) ? 0.0f : 1.0f;
 		else
 			frag->texType = 2.0f;
-		#endif
 //		printf("frag->texType = %d\n", frag->texType);
 	} else {
 		frag->type = NSVG_SHADER_FILLGRAD;
@@ -971,10 +985,34 @@ static int glnvg__convertPaint(GLNVGcontext* gl, GLNVGfragUniforms* frag, NVGpai
 
 static GLNVGfragUniforms* nvg__fragUniformPtr(GLNVGcontext* gl, int i);
 
+#if NANOVG_GL_USE_UNIFORMBUFFER
+// Selects where the shader takes the uniform struct index from: the per vertex indices,
+// relative to the given base, or the first struct of the bound range if base is -1
+static void glnvg__useVertFrags(GLNVGcontext* gl, int base)
+{
+	if (base >= 0 && !gl->vertFragsEnabled) {
+		glEnableVertexAttribArray(2);
+		gl->vertFragsEnabled = 1;
+	} else if (base < 0 && gl->vertFragsEnabled) {
+		glDisableVertexAttribArray(2);
+		// The current value of an attribute is undefined after drawing with its array enabled
+		glVertexAttribI4i(2, 0, 0, 0, 0);
+		gl->vertFragsEnabled = 0;
+	}
+
+	if (base < 0) base = 0;
+	if (gl->fragBase != base) {
+		glUniform1i(gl->shader.loc[GLNVG_LOC_FRAGBASE], base);
+		gl->fragBase = base;
+	}
+}
+#endif
+
 static void glnvg__setUniforms(GLNVGcontext* gl, int uniformOffset, int image)
 {
 #if NANOVG_GL_USE_UNIFORMBUFFER
-	glBindBufferRange(GL_UNIFORM_BUFFER, GLNVG_FRAG_BINDING, gl->fragBuf, uniformOffset, sizeof(GLNVGfragUniforms));
+	glnvg__useVertFrags(gl, -1);
+	glBindBufferRange(GL_UNIFORM_BUFFER, GLNVG_FRAG_BINDING, gl->fragBuf, uniformOffset, gl->fragCount * gl->fragSize);
 #else
 	GLNVGfragUniforms* frag = nvg__fragUniformPtr(gl, uniformOffset);
 	glUniform4fv(gl->shader.loc[GLNVG_LOC_FRAG], NANOVG_GL_UNIFORMARRAY_SIZE, &(frag->uniformArray[0][0]));
@@ -1113,6 +1151,56 @@ static void glnvg__triangles(GLNVGcontext* gl, GLNVGcall* call)
 	glDrawArrays(GL_TRIANGLES, call->triangleOffset, call->triangleCount);
 }
 
+#if NANOVG_GL_USE_UNIFORMBUFFER
+// Returns how many of the calls following the given one can be drawn along with it:
+// triangles with the same blending, right after in the vertex buffer, with their uniforms
+// in the same range and the same image (or none, untextured paints never sample it).
+// Their vertex count is added to triangleCount and the image to bind is set in image.
+static int glnvg__mergeableTriangles(GLNVGcontext* gl, int first, int* triangleCount, int* image)
+{
+	GLNVGcall* call = &gl->calls[first];
+	int i;
+
+	*triangleCount = call->triangleCount;
+	*image = call->image;
+
+	for (i = first + 1; i < gl->ncalls; i++) {
+		GLNVGcall* next = &gl->calls[i];
+		if (next->type != GLNVG_TRIANGLES)
+			break;
+		if (next->image != 0 && *image != 0 && next->image != *image)
+			break;
+		if (memcmp(&next->blendFunc, &call->blendFunc, sizeof(GLNVGblend)) != 0)
+			break;
+		if (next->triangleOffset != call->triangleOffset + *triangleCount)
+			break;
+		if ((next->uniformOffset - call->uniformOffset) / gl->fragSize >= gl->fragCount)
+			break;
+		*triangleCount += next->triangleCount;
+		if (next->image != 0)
+			*image = next->image;
+	}
+
+	return i - first - 1;
+}
+
+static void glnvg__mergedTriangles(GLNVGcontext* gl, GLNVGcall* call, int triangleCount, int image)
+{
+	glnvg__useVertFrags(gl, call->uniformOffset / gl->fragSize);
+	glBindBufferRange(GL_UNIFORM_BUFFER, GLNVG_FRAG_BINDING, gl->fragBuf, call->uniformOffset, gl->fragCount * gl->fragSize);
+
+	if (image != 0) {
+		GLNVGtexture* tex = glnvg__findTexture(gl, image);
+		glnvg__bindTexture(gl, tex != NULL ? tex->tex : 0);
+	} else {
+		glnvg__bindTexture(gl, 0);
+	}
+	glnvg__checkError(gl, "merged triangles fill");
+
+	glDrawArrays(GL_TRIANGLES, call->triangleOffset, triangleCount);
+}
+#endif
+
 static void glnvg__renderCancel(void* uptr) {
 	GLNVGcontext* gl = (GLNVGcontext*)uptr;
 	gl->nverts = 0;
@@ -1200,9 +1288,11 @@ static void glnvg__renderFlush(void* uptr)
 		#endif
 
 #if NANOVG_GL_USE_UNIFORMBUFFER
-		// Upload ubo for frag shaders
+		// Upload ubo for frag shaders, with room after the last struct
+		// for the full size ranges bound by glnvg__setUniforms()
 		glBindBuffer(GL_UNIFORM_BUFFER, gl->fragBuf);
-		glBufferData(GL_UNIFORM_BUFFER, gl->nuniforms * gl->fragSize, gl->uniforms, GL_STREAM_DRAW);
+		glBufferData(GL_UNIFORM_BUFFER, (gl->nuniforms + gl->fragCount) * gl->fragSize, NULL, GL_STREAM_DRAW);
+		glBufferSubData(GL_UNIFORM_BUFFER, 0, gl->nuniforms * gl->fragSize, gl->uniforms);
 #endif
 
 		// Upload vertex data
@@ -1216,6 +1306,18 @@ static void glnvg__renderFlush(void* uptr)
 		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(NVGvertex), (const GLvoid*)(size_t)0);
 		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(NVGvertex), (const GLvoid*)(0 + 2*sizeof(float)));
 
+#if NANOVG_GL_USE_UNIFORMBUFFER
+		// Upload the uniform struct indices, only used by merged calls
+		glBindBuffer(GL_ARRAY_BUFFER, gl->vertFragBuf);
+		glBufferData(GL_ARRAY_BUFFER, gl->nverts * sizeof(int), gl->vertFrags, GL_STREAM_DRAW);
+		glVertexAttribIPointer(2, 1, GL_INT, sizeof(int), (const GLvoid*)(size_t)0);
+		glVertexAttribI4i(2, 0, 0, 0, 0);
+		glDisableVertexAttribArray(2);
+		gl->vertFragsEnabled = 0;
+		gl->fragBase = 0;
+		glUniform1i(gl->shader.loc[GLNVG_LOC_FRAGBASE], 0);
+#endif
+
 		// Set view and texture just once per frame.
 		glUniform1i(gl->shader.loc[GLNVG_LOC_TEX], 0);
 		glUniform2fv(gl->shader.loc[GLNVG_LOC_VIEWSIZE], 1, gl->view);
@@ -1233,12 +1335,25 @@ static void glnvg__renderFlush(void* uptr)
 				glnvg__convexFill(gl, call);
 			else if (call->type == GLNVG_STROKE)
 				glnvg__stroke(gl, call);
-			else if (call->type == GLNVG_TRIANGLES)
+			else if (call->type == GLNVG_TRIANGLES) {
+#if NANOVG_GL_USE_UNIFORMBUFFER
+				int triangleCount, image;
+				int merged = glnvg__mergeableTriangles(gl, i, &triangleCount, &image);
+				if (merged > 0) {
+					glnvg__mergedTriangles(gl, call, triangleCount, image);
+					i += merged;
+					continue;
+				}
+#endif
 				glnvg__triangles(gl, call);
+			}
 		}
 
 		glDisableVertexAttribArray(0);
 		glDisableVertexAttribArray(1);
+#if NANOVG_GL_USE_UNIFORMBUFFER
+		glDisableVertexAttribArray(2);
+#endif
 #if defined NANOVG_GL3
 		glBindVertexArray(0);
 #endif
@@ -1303,6 +1418,11 @@ static int glnvg__allocVerts(GLNVGcontext* gl, int n)
 	if (gl->nverts+n > gl->cverts) {
 		NVGvertex* verts;
 		int cverts = glnvg__maxi(gl->nverts + n, 4096) + gl->cverts/2; // 1.5x Overallocate
+#if NANOVG_GL_USE_UNIFORMBUFFER
+		int* vertFrags = (int*)realloc(gl->vertFrags, sizeof(int) * cverts);
+		if (vertFrags == NULL) return -1;
+		gl->vertFrags = vertFrags;
+#endif
 		verts = (NVGvertex*)realloc(gl->verts, sizeof(NVGvertex) * cverts);
 		if (verts == NULL) return -1;
 		gl->verts = verts;
@@ -1342,6 +1462,55 @@ static void glnvg__vset(NVGvertex* vtx, float x, float y, float u, float v)
 	vtx->v = v;
 }
 
+#if NANOVG_GL_USE_UNIFORMBUFFER
+// Copies a convex fill as a list of triangles instead of a fan and a strip,
+// so that it can be merged with the calls around it
+static int glnvg__convexFillTriangles(GLNVGcontext* gl, GLNVGcall* call, const NVGpath* path)
+{
+	int i, nfill, nstroke, offset;
+	NVGvertex* dst;
+
+	nfill = path->nfill >= 3 ? (path->nfill - 2) * 3 : 0;
+	nstroke = path->nstroke >= 3 ? (path->nstroke - 2) * 3 : 0;
+
+	offset = glnvg__allocVerts(gl, nfill + nstroke);
+	if (offset == -1) return -1;
+	dst = &gl->verts[offset];
+
+	for (i = 2; i < path->nfill; i++) {
+		*dst++ = path->fill[0];
+		*dst++ = path->fill[i - 1];
+		*dst++ = path->fill[i];
+	}
+
+	// Every other triangle of a strip is flipped, swap two vertices to keep the winding
+	for (i = 2; i < path->nstroke; i++) {
+		if (i % 2 == 0) {
+			*dst++ = path->stroke[i - 2];
+			*dst++ = path->stroke[i - 1];
+		} else {
+			*dst++ = path->stroke[i - 1];
+			*dst++ = path->stroke[i - 2];
+		}
+		*dst++ = path->stroke[i];
+	}
+
+	call->type = GLNVG_TRIANGLES;
+	call->pathCount = 0;
+	call->triangleOffset = offset;
+	call->triangleCount = nfill + nstroke;
+	return 0;
+}
+
+// Points the vertices of the call to its uniform struct
+static void glnvg__setVertFrags(GLNVGcontext* gl, GLNVGcall* call)
+{
+	int i, index = call->uniformOffset / gl->fragSize;
+	for (i = 0; i < call->triangleCount; i++)
+		gl->vertFrags[call->triangleOffset + i] = index;
+}
+#endif
+
 static void glnvg__renderFill(void* uptr, NVGpaint* paint, NVGcompositeOperationState compositeOperation, NVGscissor* scissor, float fringe,
 							  const float* bounds, const NVGpath* paths, int npaths)
 {
@@ -1355,11 +1524,25 @@ static void glnvg__renderFill(void* uptr, NVGpaint* paint, NVGcompositeOperation
 
 	call->type = GLNVG_FILL;
 	call->triangleCount = 4;
+	call->image = paint->image;
+	call->blendFunc = glnvg__blendCompositeOperation(compositeOperation);
+
+#if NANOVG_GL_USE_UNIFORMBUFFER
+	// Convex fills don't need the stencil buffer, draw them as plain triangles
+	if (npaths == 1 && paths[0].convex) {
+		if (glnvg__convexFillTriangles(gl, call, &paths[0]) == -1) goto error;
+
+		call->uniformOffset = glnvg__allocFragUniforms(gl, 1);
+		if (call->uniformOffset == -1) goto error;
+		glnvg__convertPaint(gl, nvg__fragUniformPtr(gl, call->uniformOffset), paint, scissor, fringe, fringe, -1.0f);
+		glnvg__setVertFrags(gl, call);
+		return;
+	}
+#endif
+
 	call->pathOffset = glnvg__allocPaths(gl, npaths);
 	if (call->pathOffset == -1) goto error;
 	call->pathCount = npaths;
-	call->image = paint->image;
-	call->blendFunc = glnvg__blendCompositeOperation(compositeOperation);
 
 	if (npaths == 1 && paths[0].convex)
 	{
@@ -1506,6 +1689,9 @@ static void glnvg__renderTriangles(void* uptr, NVGpaint* paint, NVGcompositeOper
 	frag = nvg__fragUniformPtr(gl, call->uniformOffset);
 	glnvg__convertPaint(gl, frag, paint, scissor, 1.0f, 1.0f, -1.0f);
 	frag->type = NSVG_SHADER_IMG;
+#if NANOVG_GL_USE_UNIFORMBUFFER
+	glnvg__setVertFrags(gl, call);
+#endif
 
 	return;
 
@@ -1527,6 +1713,8 @@ static void glnvg__renderDelete(void* uptr)
 #if NANOVG_GL_USE_UNIFORMBUFFER
 	if (gl->fragBuf != 0)
 		glDeleteBuffers(1, &gl->fragBuf);
+	if (gl->vertFragBuf != 0)
+		glDeleteBuffers(1, &gl->vertFragBuf);
 #endif
 	if (gl->vertArr != 0)
 		glDeleteVertexArrays(1, &gl->vertArr);
@@ -1542,6 +1730,9 @@ static void glnvg__renderDelete(void* uptr)
 
 	free(gl->paths);
 	free(gl->verts);
+#if NANOVG_GL_USE_UNIFORMBUFFER
+	free(gl->vertFrags);
+#endif
 	free(gl->uniforms);
 	free(gl->calls);
 
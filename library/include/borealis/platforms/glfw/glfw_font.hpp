@@ -25,6 +25,7 @@ namespace brls
 class GLFWFontLoader : public FontLoader
 {
   public:
+    void preloadFonts() override;
     void loadFonts() override;
 };
 
@@ -37,6 +37,8 @@ class GLFWVideoContext : public VideoContext
     void beginFrame() override;
     void endFrame() override;
     void resetState() override;
+    void setVSync(bool enabled) override;
+    float getDisplayRefreshRate() override;
 
     GLFWwindow* getGLFWWindow();
 
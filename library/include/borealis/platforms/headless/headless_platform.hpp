@@ -0,0 +1,64 @@
+/*
+    Copyright 2021 natinusala
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+#pragma once
+
+#include <borealis/core/platform.hpp>
+#include <borealis/platforms/headless/headless_font.hpp>
+#include <borealis/platforms/headless/headless_video.hpp>
+
+namespace brls
+{
+
+// Input manager that never reports any button
+class HeadlessInputManager : public InputManager
+{
+  public:
+    void updateControllerState(ControllerState* state) override
+    {
+    }
+};
+
+// Platform without window, inputs nor audio, for benchmarks and automated runs.
+// Selected instead of any other platform when built with __HEADLESS__.
+// The main loop runs forever, until Application::quit() is called.
+class HeadlessPlatform : public Platform
+{
+  public:
+    HeadlessPlatform();
+    ~HeadlessPlatform();
+
+    std::string getName() override;
+    void createWindow(std::string windowTitle, uint32_t windowWidth, uint32_t windowHeight) override;
+
+    bool mainLoopIteration() override;
+    ThemeVariant getThemeVariant() override;
+    std::string getLocale() override;
+
+    AudioPlayer* getAudioPlayer() override;
+    VideoContext* getVideoContext() override;
+    InputManager* getInputManager() override;
+    FontLoader* getFontLoader() override;
+
+  private:
+    NullAudioPlayer* audioPlayer       = nullptr;
+    HeadlessVideoContext* videoContext = nullptr;
+    HeadlessInputManager* inputManager = nullptr;
+    HeadlessFontLoader* fontLoader     = nullptr;
+};
+
+} // namespace brls
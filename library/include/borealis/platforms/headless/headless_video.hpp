@@ -0,0 +1,61 @@
+/*
+    Copyright 2021 natinusala
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+#pragma once
+
+#include <borealis/core/video.hpp>
+#include <string>
+#include <unordered_map>
+
+namespace brls
+{
+
+// Video context without any window or GPU: nanovg runs with a back-end that
+// draws nothing, so text measuring, layout and image decoding still work.
+// Textures only exist as sizes.
+class HeadlessVideoContext : public VideoContext
+{
+  public:
+    HeadlessVideoContext(uint32_t windowWidth, uint32_t windowHeight);
+    ~HeadlessVideoContext();
+
+    NVGcontext* getNVGContext() override;
+
+    void clear(NVGcolor color) override;
+    void beginFrame() override;
+    void endFrame() override;
+    void resetState() override;
+    void setVSync(bool enabled) override;
+    float getDisplayRefreshRate() override;
+
+  private:
+    struct TextureSize
+    {
+        int width, height;
+    };
+
+    static int createTexture(void* context, int type, int width, int height, int flags, const unsigned char* data);
+    static int deleteTexture(void* context, int texture);
+    static int getTextureSize(void* context, int texture, int* width, int* height);
+
+    NVGcontext* nvgContext = nullptr;
+
+    std::unordered_map<int, TextureSize> textures;
+    int nextTexture = 1;
+};
+
+} // namespace brls
@@ -25,6 +25,7 @@ namespace brls
 class SwitchFontLoader : public FontLoader
 {
   public:
+    void preloadFonts() override;
     void loadFonts() override;
 };
 
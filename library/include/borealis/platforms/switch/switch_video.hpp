@@ -43,6 +43,8 @@ class SwitchVideoContext : public VideoContext
     void resetState() override;
     void beginFrame() override;
     void endFrame() override;
+    void setVSync(bool enabled) override;
+    float getDisplayRefreshRate() override;
     virtual NVGcontext* getNVGContext() override;
 
     void appletCallback(AppletHookType hookType);
@@ -51,6 +53,8 @@ class SwitchVideoContext : public VideoContext
     _LibNXEvent defaultDisplayResolutionChangeEvent;
     bool displayResolutionChangeEventReady = true;
 
+    bool vsync = true;
+
     void resetFramebuffer(); // triggered by either display resolution change event or operation mode change event
     void updateWindowSize();
     void createFramebufferResources();
@@ -18,6 +18,7 @@
 
 #include <borealis/core/view.hpp>
 #include <borealis/core/box.hpp>
+#include <borealis/views/label.hpp>
 
 namespace brls
 {
@@ -26,15 +27,24 @@ namespace brls
 struct Hint : public Box
 {
     Hint();
-    ~Hint();
 
     static View* create();
 
     private:
+    /**
+     * Rebuilds the hints at the beginning of the next frame, once
+     * no matter how many times it's called until then.
+     */
+    void scheduleRebuild();
+
     void rebuildHints();
 
-    GenericEvent::Subscription globalFocusEventSubscriptor;
-    VoidEvent::Subscription globalHintsUpdateEventSubscriptor;
+    bool rebuildScheduled = false;
+
+    std::vector<Label*> labels;
+
+    ScopedSubscription globalFocusEventSubscription;
+    ScopedSubscription globalHintsUpdateEventSubscription;
 };
 
 } // namespace brls
\ No newline at end of file
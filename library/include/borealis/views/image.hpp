@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <borealis/core/image_atlas.hpp>
 #include <borealis/core/view.hpp>
 
 namespace brls
@@ -79,6 +80,42 @@ class Image : public View
      */
     void setInterpolation(ImageInterpolation interpolation);
 
+    /**
+     * Sets the atlas group of the image: images of the same group are packed
+     * in shared textures, which makes drawing many of them a lot cheaper (see ImageAtlas).
+     *
+     * By default (empty group), the image is packed if it's smaller than the
+     * atlas size threshold. Use "none" to never pack it.
+     *
+     * Like the interpolation, this only takes effect after (re) loading the image.
+     * If you are using the atlas XML attribute, you have to set it before the
+     * actual image attribute.
+     */
+    void setAtlasGroup(std::string group);
+
+    /**
+     * Sets the largest size the image will be drawn at, in the same unit as the
+     * view size. Bigger images are downscaled on the CPU when they are loaded, so that
+     * their texture doesn't take more memory than needed (thumbnails of screenshots...).
+     *
+     * Use View::AUTO to take the size from the layout instead: the image
+     * is then decoded after the first layout, and decoded again if it grows
+     * (or shrinks a lot). Default is 0, for no limit.
+     *
+     * Like the interpolation, this only takes effect after (re) loading the image.
+     */
+    void setMaxDecodeSize(float size);
+
+    /**
+     * Enables mipmaps generation for the texture of the image. Avoids aliasing when
+     * the image is drawn a lot smaller than its texture, for instance when FIT or
+     * CROP images shrink during an animation. Takes a third more memory.
+     *
+     * Mipmapped images are never packed in an atlas.
+     * Like the interpolation, this only takes effect after (re) loading the image.
+     */
+    void setMipmapsEnabled(bool enabled);
+
     /**
      * Sets the image from the given resource name.
      *
@@ -114,6 +151,12 @@ class Image : public View
     void setImageAlign(ImageAlignment align);
 
     int getTexture();
+
+    /**
+     * Returns the memory used by the texture of the image, in bytes.
+     * Images packed in an atlas don't have their own texture: it's then 0.
+     */
+    size_t getTextureSize();
     float getOriginalImageWidth();
     float getOriginalImageHeight();
 
@@ -126,8 +169,22 @@ class Image : public View
 
     int texture = 0;
 
+    std::string atlasGroup;
+    AtlasImage* atlasImage = nullptr; // if packed, texture is then the atlas page
+
+    std::string imagePath;
+    float maxDecodeSize = 0; // 0 for no limit, View::AUTO to follow the layout
+    bool mipmaps        = false;
+
+    int decodedWidth  = 0;
+    int decodedHeight = 0;
+
     NVGpaint paint;
 
+    void freeImage();
+    void decodeImage(int maxWidth, int maxHeight);
+    void updateDecodeSize();
+
     void invalidateImageBounds();
     int getImageFlags();
 
@@ -47,6 +47,10 @@ class ScrollingFrame : public Box
     void willAppear(bool resetState) override;
     void addView(View* view) override;
     void removeView(View* view) override;
+    void addViews(const std::vector<View*>& views, size_t position) override;
+    void removeViewsRange(size_t start, size_t count) override;
+    void removeAllViews() override;
+    bool detachView(View* view) override;
     void onLayout() override;
     void setPadding(float top, float right, float bottom, float left) override;
     void setPaddingTop(float top) override;
@@ -54,6 +58,8 @@ class ScrollingFrame : public Box
     void setPaddingBottom(float bottom) override;
     void setPaddingLeft(float left) override;
 
+    using Box::addViews;
+
     /**
      * Sets the content view of this scrolling box. There can only be one
      * content view per scrolling box at a time.
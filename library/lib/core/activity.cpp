@@ -164,8 +164,45 @@ View* Activity::getView(std::string id)
     return this->contentView->getView(id);
 }
 
+void Activity::setArenaEnabled(bool enabled, size_t blockSize)
+{
+    // The views of the content are in the current arena
+    if (this->contentLoaded)
+        fatal("Activity::setArenaEnabled() must be called before the content of the activity is loaded");
+
+    if (enabled)
+        this->arena = std::make_unique<Arena>(blockSize);
+    else
+        this->arena = nullptr;
+}
+
+Arena* Activity::getArena()
+{
+    return this->arena.get();
+}
+
+void Activity::loadContent()
+{
+    if (this->contentLoaded)
+        return;
+
+    ArenaScope scope(this->getArena());
+
+    this->setContentView(this->createContentView());
+    this->onContentAvailable();
+
+    this->contentLoaded = true;
+}
+
+bool Activity::isContentLoaded()
+{
+    return this->contentLoaded;
+}
+
 Activity::~Activity()
 {
+    Application::cancelActivityPreload(this);
+
     if (this->contentView)
     {
         this->contentView->willDisappear();
@@ -173,6 +210,9 @@ Activity::~Activity()
         delete this->contentView;
         this->contentView = nullptr;
     }
+
+    if (this->arena)
+        BRLS_LOG_DEBUG("Releasing activity arena ({} bytes)", this->arena->getSize());
 }
 
 } // namespace brls
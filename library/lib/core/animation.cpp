@@ -22,11 +22,19 @@ namespace brls
 
 Animatable::Animatable(float value)
     : currentValue(value)
+    , previousValue(value)
 {
 }
 
+Animatable::~Animatable()
+{
+    // ~Ticking() stops us once onStop() cannot be called anymore
+    this->finishWaiters.release();
+}
+
 void Animatable::onReset()
 {
+    this->previousValue = this->currentValue;
     this->tween = tweeny::tween<float>::from(this->currentValue);
 }
 
@@ -43,7 +51,16 @@ void Animatable::reset()
 
 void Animatable::onRewind()
 {
-    this->currentValue = this->tween.seek(0);
+    this->currentValue  = this->tween.seek(0);
+    this->previousValue = this->currentValue;
+}
+
+void Animatable::onStop()
+{
+    // Don't stay stuck between the last two steps once the animation is over
+    this->previousValue = this->currentValue;
+
+    this->finishWaiters.release();
 }
 
 void Animatable::addStep(float targetValue, int32_t duration, EasingFunction easing)
@@ -56,27 +73,36 @@ float Animatable::getProgress()
     return this->tween.progress();
 }
 
-bool Animatable::onUpdate(retro_time_t delta)
+bool Animatable::onUpdate(float delta)
 {
-    // int32_t for stepping works as long as the app goes faster than 0.00001396983 FPS
-    // (in which case the delta for a frame wraps in an int32_t)
-    this->currentValue = this->tween.step((int32_t)delta);
+    this->previousValue = this->currentValue;
+
+    // Step by progress instead of by time to keep sub-ms precision
+    uint32_t duration = this->tween.duration();
+
+    if (duration == 0)
+        this->currentValue = this->tween.seek(1.0f);
+    else
+        this->currentValue = this->tween.step(delta / (float)duration);
+
     return this->tween.progress() < 1.0f;
 }
 
 float Animatable::getValue()
 {
-    return this->currentValue;
+    float alpha = Ticking::getInterpolationAlpha();
+    return this->previousValue + (this->currentValue - this->previousValue) * alpha;
 }
 
 Animatable::operator float() const
 {
-    return this->currentValue;
+    float alpha = Ticking::getInterpolationAlpha();
+    return this->previousValue + (this->currentValue - this->previousValue) * alpha;
 }
 
 Animatable::operator float()
 {
-    return this->currentValue;
+    return this->getValue();
 }
 
 void Animatable::operator=(const float value)
@@ -97,7 +123,7 @@ static double highlightColor     = 0;
 
 void updateHighlightAnimation()
 {
-    Time currentTime = getCPUTimeUsec() / 1000;
+    double currentTime = (double)getCPUTimeUsec() / 1000.0;
 
     // Update variables
     highlightGradientX = (cos((double)currentTime / HIGHLIGHT_SPEED / 3.0) + 1.0) / 2.0;
@@ -22,9 +22,15 @@
 
 #include <algorithm>
 #include <borealis/core/application.hpp>
+#include <borealis/core/async.hpp>
+#include <borealis/core/coroutine.hpp>
 #include <borealis/core/font.hpp>
 #include <borealis/core/i18n.hpp>
+#include <borealis/core/latency.hpp>
+#include <borealis/core/memory.hpp>
+#include <borealis/core/shadow_cache.hpp>
 #include <borealis/core/time.hpp>
+#include <borealis/core/trace.hpp>
 #include <borealis/core/util.hpp>
 #include <borealis/views/button.hpp>
 #include <borealis/views/header.hpp>
@@ -49,9 +55,6 @@
 constexpr uint32_t ORIGINAL_WINDOW_WIDTH  = 1280;
 constexpr uint32_t ORIGINAL_WINDOW_HEIGHT = 720;
 
-#define BUTTON_REPEAT_DELAY 15
-#define BUTTON_REPEAT_CADENCY 5
-
 namespace brls
 {
 
@@ -130,16 +133,15 @@ const std::string shadowThemeXML = R"xml(
 
 bool Application::init()
 {
+    BRLS_TRACE_THREAD_NAME("main");
+
+    Application::startup.begin();
+
     // Init platform
     Application::platform = Platform::createPlatform();
     Application::theme = new Theme("brls/default");
     Application::style = new Style(*Application::theme);
 
-    Application::theme->inflateFromXMLString(generalThemeXML);
-    Application::theme->inflateFromXMLString(highlightThemeXML);
-    Application::theme->inflateFromXMLString(animationThemeXML);
-    Application::theme->inflateFromXMLString(shadowThemeXML);
-
     if (!Application::platform)
     {
         fatal("Did not find a valid platform");
@@ -148,18 +150,31 @@ bool Application::init()
 
     Logger::info("Using platform {}", platform->getName());
 
+    // Parse the stylesheets, translations and read font files in the background
+    // while the main thread creates the window, see createWindow()
+    Application::stylesheetsStep = Application::startup.addStep("stylesheets", StartupThread::WORKER, {}, [] {
+        Application::theme->inflateFromXMLString(generalThemeXML);
+        Application::theme->inflateFromXMLString(highlightThemeXML);
+        Application::theme->inflateFromXMLString(animationThemeXML);
+        Application::theme->inflateFromXMLString(shadowThemeXML);
+    });
+
     // Init i18n
     if (Application::usingi18n)
-    {
         Logger::info("i18n has been enabled. Initializing translations...");
-        i18nChecker();
-        loadTranslations();
-    }
     else
-    {
         Logger::info("i18n has been disabled. Initializing only internal translations...");
-        loadInternal(); // Load internal translations (required for built-in views)
-    }
+
+    Application::translationsStep = Application::startup.addStep("i18n", StartupThread::WORKER, {}, [] {
+        if (Application::usingi18n)
+            loadTranslations();
+        else
+            loadInternal(); // Load internal translations (required for built-in views)
+    });
+
+    Application::fontFilesStep = Application::startup.addStep("font files", StartupThread::WORKER, {}, [] {
+        Application::platform->getFontLoader()->preloadFonts();
+    });
 
     Application::inited = true;
     return true;
@@ -173,17 +188,28 @@ void Application::createWindow(std::string windowTitle)
         return;
     }
 
-    // Create the actual window
-    Application::getPlatform()->createWindow(windowTitle, ORIGINAL_WINDOW_WIDTH, ORIGINAL_WINDOW_HEIGHT);
+    StartupGraph* startup = &Application::startup;
+
+    // Create the actual window and setup frame pacing
+    StartupStep* window = startup->addStep("window", StartupThread::MAIN, {}, [windowTitle] {
+        Application::getPlatform()->createWindow(windowTitle, ORIGINAL_WINDOW_WIDTH, ORIGINAL_WINDOW_HEIGHT);
+
+        VideoContext* videoContext = Application::getPlatform()->getVideoContext();
+        videoContext->setVSync(Application::vsync);
+        Logger::info("Display refresh rate: {}Hz", videoContext->getDisplayRefreshRate());
+        Application::updateFramePacing();
+    });
 
     // Load most commonly used sounds
-    AudioPlayer* audioPlayer = Application::getAudioPlayer();
-    for (enum Sound sound : {
-             SOUND_FOCUS_CHANGE,
-             SOUND_FOCUS_ERROR,
-             SOUND_CLICK,
-         })
-        audioPlayer->load(sound);
+    startup->addStep("sounds", StartupThread::MAIN, { window }, [] {
+        AudioPlayer* audioPlayer = Application::getAudioPlayer();
+        for (enum Sound sound : {
+                 SOUND_FOCUS_CHANGE,
+                 SOUND_FOCUS_ERROR,
+                 SOUND_CLICK,
+             })
+            audioPlayer->load(sound);
+    });
 
     // Init rng
     std::srand(std::time(nullptr));
@@ -193,54 +219,66 @@ void Application::createWindow(std::string windowTitle)
     Application::title        = windowTitle;
 
     // Init yoga
-    YGConfig* defaultConfig       = YGConfigGetDefault();
-    defaultConfig->useWebDefaults = true;
+    startup->addStep("yoga", StartupThread::MAIN, {}, [] {
+        YGConfig* defaultConfig       = YGConfigGetDefault();
+        defaultConfig->useWebDefaults = true;
 
-    yoga::Event::subscribe([](const YGNode& node, yoga::Event::Type eventType, yoga::Event::Data eventData) {
-        View* view = (View*)node.getContext();
+        yoga::Event::subscribe([](const YGNode& node, yoga::Event::Type eventType, yoga::Event::Data eventData) {
+            View* view = (View*)node.getContext();
 
-        if (!view)
-            return;
+            if (!view)
+                return;
 
-        if (eventType == yoga::Event::NodeLayout)
-            view->onLayout();
+            if (eventType == yoga::Event::NodeLayout)
+                view->onLayout();
+        });
     });
 
-    // Load fonts and setup fallbacks
-    Application::platform->getFontLoader()->loadFonts();
+    // Load fonts and setup fallbacks, needs the graphics context
+    startup->addStep("fonts", StartupThread::MAIN, { window, Application::fontFilesStep }, [] {
+        Application::platform->getFontLoader()->loadFonts();
 
-    int regular = Application::getFont(FONT_REGULAR);
-    if (regular != FONT_INVALID)
-    {
-        NVGcontext* vg = Application::getNVGContext();
+        int regular = Application::getFont(FONT_REGULAR);
+        if (regular != FONT_INVALID)
+        {
+            NVGcontext* vg = Application::getNVGContext();
 
-        // Switch icons
-        int switchIcons = Application::getFont(FONT_SWITCH_ICONS);
-        if (switchIcons != FONT_INVALID)
-            nvgAddFallbackFontId(vg, regular, switchIcons);
-        else
-            Logger::warning("Switch icons font was not loaded, icons will not be displayed");
+            // Switch icons
+            int switchIcons = Application::getFont(FONT_SWITCH_ICONS);
+            if (switchIcons != FONT_INVALID)
+                nvgAddFallbackFontId(vg, regular, switchIcons);
+            else
+                Logger::warning("Switch icons font was not loaded, icons will not be displayed");
 
-        // Material icons
-        int materialIcons = Application::getFont(FONT_MATERIAL_ICONS);
-        if (materialIcons != FONT_INVALID)
-            nvgAddFallbackFontId(vg, regular, materialIcons);
+            // Material icons
+            int materialIcons = Application::getFont(FONT_MATERIAL_ICONS);
+            if (materialIcons != FONT_INVALID)
+                nvgAddFallbackFontId(vg, regular, materialIcons);
+            else
+                Logger::warning("Material icons font was not loaded, icons will not be displayed");
+        }
         else
-            Logger::warning("Material icons font was not loaded, icons will not be displayed");
-    }
-    else
-    {
-        Logger::warning("Regular font was not loaded, there will be no text displayed in the app");
-    }
+        {
+            Logger::warning("Regular font was not loaded, there will be no text displayed in the app");
+        }
+    });
 
     // Register built-in XML views
-    Application::registerBuiltInXMLViews();
+    startup->addStep("xml views", StartupThread::MAIN, {}, [] {
+        Application::registerBuiltInXMLViews();
+    });
+
+    // Run the main thread steps and join the background ones
+    startup->finish();
 }
 
-bool Application::mainLoop()
+void Application::waitForTranslations()
 {
-    static ControllerState oldControllerState = {};
+    Application::startup.wait(Application::translationsStep);
+}
 
+bool Application::mainLoop()
+{
     // Main loop callback
     if (!Application::platform->mainLoopIteration() || Application::quitRequested)
     {
@@ -248,48 +286,79 @@ bool Application::mainLoop()
         return false;
     }
 
-    // Input
-    ControllerState controllerState = {};
+    FramePacer* pacer = &Application::framePacer;
+    pacer->beginFrame();
 
-    InputManager* inputManager = Application::platform->getInputManager();
-    inputManager->updateControllerState(&controllerState);
+    BRLS_TRACE_SCOPE("mainLoop");
 
-    // Trigger controller events
-    bool anyButtonPressed           = false;
-    bool repeating                  = false;
-    static Time buttonPressTime     = 0;
-    static int repeatingButtonTimer = 0;
+    float delta = pacer->getFrameDelta();
 
-    for (int i = 0; i < _BUTTON_MAX; i++)
+    // Input
     {
-        if (controllerState.buttons[i])
+        BRLS_TRACE_SCOPE("input");
+
+        ControllerState controllerState = {};
+
+        InputManager* inputManager = Application::platform->getInputManager();
+        inputManager->updateControllerState(&controllerState);
+
+        if (controllerState.timestamp == 0)
+            controllerState.timestamp = getCPUTimeUsec();
+
+        // Trigger controller events
+        const std::vector<KeyPress>& presses = Application::keyRepeater.update(controllerState);
+        Application::inputThisFrame          = !presses.empty();
+
+        for (const KeyPress& press : presses)
         {
-            anyButtonPressed = true;
-            repeating        = (repeatingButtonTimer > BUTTON_REPEAT_DELAY && repeatingButtonTimer % BUTTON_REPEAT_CADENCY == 0);
+            LatencyTracer::beginTrace(controllerState.timestamp);
 
-            if (!oldControllerState.buttons[i] || repeating)
-                Application::onControllerButtonPressed((enum ControllerButton)i, repeating);
+            for (unsigned i = 0; i < press.count; i++)
+                Application::onControllerButtonPressed(press.button, press.repeating);
         }
-
-        if (controllerState.buttons[i] != oldControllerState.buttons[i])
-            buttonPressTime = repeatingButtonTimer = 0;
     }
 
-    if (anyButtonPressed && getCPUTimeUsec() - buttonPressTime > 1000)
+    LatencyTracer::mark(LatencyStage::ACTION_DISPATCHED);
+
+    // Background tasks completions
     {
-        buttonPressTime = getCPUTimeUsec();
-        repeatingButtonTimer++; // Increased once every ~1ms
+        BRLS_TRACE_SCOPE("mainThreadTasks");
+        TaskPool::processMainThreadTasks();
     }
 
-    oldControllerState = controllerState;
-
     // Animations
-    updateHighlightAnimation();
-    Ticking::updateTickings();
+    {
+        BRLS_TRACE_SCOPE("tickings");
+
+        updateHighlightAnimation();
+
+        if (pacer->getFixedTimestep() > 0.0f)
+        {
+            while (pacer->consumeFixedStep())
+                Ticking::updateTickings(pacer->getFixedTimestep());
+        }
+        else
+        {
+            Ticking::updateTickings(delta);
+        }
+
+        Ticking::setInterpolationAlpha(pacer->getInterpolationAlpha());
+    }
+
+    // Coroutines
+    {
+        BRLS_TRACE_SCOPE("coroutines");
+        CoroutineScheduler::update();
+    }
 
     // Render
     Application::frame();
 
+    // Use the rest of idle frames to prepare activities
+    Application::preloadNextActivity();
+
+    pacer->endFrame();
+
     return true;
 }
 
@@ -303,12 +372,17 @@ AudioPlayer* Application::getAudioPlayer()
     return Application::platform->getAudioPlayer();
 }
 
+KeyRepeater* Application::getKeyRepeater()
+{
+    return &Application::keyRepeater;
+}
+
 void Application::quit()
 {
     Application::quitRequested = true;
 }
 
-void Application::navigate(FocusDirection direction)
+void Application::navigate(FocusDirection direction, bool repeating)
 {
     View* currentFocus = Application::currentFocus;
 
@@ -340,8 +414,30 @@ void Application::navigate(FocusDirection direction)
     // (in which case there is nothing to traverse)
     else if (currentFocus->hasParent())
     {
+        // Boxes with spatial navigation handle every view inside them, so start
+        // from the closest one if any instead of the direct parent
+        Box* spatialBox = nullptr;
+        View* child     = currentFocus;
+
+        for (Box* box = currentFocus->getParent(); box; child = box, box = box->getParent())
+        {
+            if (box->isSpatialNavigationEnabled())
+            {
+                spatialBox = box;
+                break;
+            }
+        }
+
         // Get next view to focus by traversing the views tree upwards
-        nextFocus = currentFocus->getParent()->getNextFocus(direction, currentFocus);
+        if (spatialBox)
+        {
+            nextFocus    = spatialBox->getNextFocus(direction, currentFocus);
+            currentFocus = child;
+        }
+        else
+        {
+            nextFocus = currentFocus->getParent()->getNextFocus(direction, currentFocus);
+        }
 
         while (!nextFocus) // stop when we find a view to focus
         {
@@ -354,8 +450,12 @@ void Application::navigate(FocusDirection direction)
     }
 
     // No view to focus at the end of the traversal: wiggle and return
+    // (only once, not on every repeat while the button is held against the edge)
     if (!nextFocus)
     {
+        if (repeating)
+            return;
+
         Application::getAudioPlayer()->play(SOUND_FOCUS_ERROR);
         Application::currentFocus->shakeHighlight(direction);
         return;
@@ -371,15 +471,10 @@ void Application::onControllerButtonPressed(enum ControllerButton button, bool r
 {
     if (Application::blockInputsTokens != 0)
     {
-        Logger::debug("{} button press blocked (tokens={})", button, Application::blockInputsTokens);
+        BRLS_LOG_DEBUG("{} button press blocked (tokens={})", button, Application::blockInputsTokens);
         return;
     }
 
-    if (repeating && Application::repetitionOldFocus == Application::currentFocus)
-        return;
-
-    Application::repetitionOldFocus = Application::currentFocus;
-
     // Actions
     if (Application::handleAction(button))
         return;
@@ -390,16 +485,16 @@ void Application::onControllerButtonPressed(enum ControllerButton button, bool r
     switch (button)
     {
         case BUTTON_DOWN:
-            Application::navigate(FocusDirection::DOWN);
+            Application::navigate(FocusDirection::DOWN, repeating);
             break;
         case BUTTON_UP:
-            Application::navigate(FocusDirection::UP);
+            Application::navigate(FocusDirection::UP, repeating);
             break;
         case BUTTON_LEFT:
-            Application::navigate(FocusDirection::LEFT);
+            Application::navigate(FocusDirection::LEFT, repeating);
             break;
         case BUTTON_RIGHT:
-            Application::navigate(FocusDirection::RIGHT);
+            Application::navigate(FocusDirection::RIGHT, repeating);
             break;
         default:
             break;
@@ -458,8 +553,12 @@ bool Application::handleAction(char button)
 
 void Application::frame()
 {
+    BRLS_TRACE_SCOPE("frame");
+
     VideoContext* videoContext = Application::platform->getVideoContext();
 
+    LatencyTracer::mark(LatencyStage::LAYOUT_DONE);
+
     // Frame context
     FrameContext frameContext = FrameContext();
 
@@ -494,34 +593,133 @@ void Application::frame()
 
     for (size_t i = 0; i < viewsToDraw.size(); i++)
     {
+        BRLS_TRACE_SCOPE("activityFrame");
+
         View* view = viewsToDraw[viewsToDraw.size() - 1 - i];
         view->frame(&frameContext);
     }
 
+    // Debug overlays
+    if (Application::framerateDisplayed)
+        Application::drawFramerate(Application::getNVGContext());
+
+    if (LatencyTracer::isOverlayEnabled())
+        LatencyTracer::drawOverlay(Application::getNVGContext(), Application::getFont(FONT_REGULAR), Application::contentWidth);
+
     // End frame
-    nvgResetTransform(Application::getNVGContext()); // scale
-    nvgEndFrame(Application::getNVGContext());
+    {
+        BRLS_TRACE_SCOPE("nvgEndFrame");
+        nvgResetTransform(Application::getNVGContext()); // scale
+        nvgEndFrame(Application::getNVGContext());
+    }
+
+    LatencyTracer::mark(LatencyStage::FRAME_SUBMITTED);
 
-    Application::platform->getVideoContext()->endFrame();
+    {
+        BRLS_TRACE_SCOPE("swapBuffers");
+        Application::platform->getVideoContext()->endFrame();
+    }
+
+    LatencyTracer::mark(LatencyStage::SWAP_RETURNED);
 }
 
 void Application::exit()
 {
     Logger::info("Exiting...");
 
+    TaskPool::stop();
+
+    Tracer::exportOnExit();
+
     Application::clear();
 
+    ShadowCache::clear(Application::getNVGContext());
+
     delete Application::platform;
 }
 
+void Application::setMaximumFPS(unsigned fps)
+{
+    Application::maximumFPS = fps;
+    Application::updateFramePacing();
+}
+
+void Application::setVSync(bool enabled)
+{
+    Application::vsync = enabled;
+
+    if (Application::platform && Application::platform->getVideoContext())
+        Application::platform->getVideoContext()->setVSync(enabled);
+
+    Application::updateFramePacing();
+}
+
+void Application::setFixedTimestep(float timestep)
+{
+    Application::framePacer.setFixedTimestep(timestep);
+}
+
+FramePacer* Application::getFramePacer()
+{
+    return &Application::framePacer;
+}
+
+void Application::updateFramePacing()
+{
+    unsigned fps = Application::maximumFPS;
+
+    // Don't fight vsync if the limit cannot be reached anyway
+    if (fps > 0 && Application::vsync && Application::platform && Application::platform->getVideoContext())
+    {
+        float refreshRate = Application::platform->getVideoContext()->getDisplayRefreshRate();
+
+        if ((float)fps >= refreshRate)
+            fps = 0;
+    }
+
+    Application::framePacer.setTargetFramerate(fps);
+}
+
 void Application::setDisplayFramerate(bool enabled)
 {
-    // To be implemented
+    Application::framerateDisplayed = enabled;
 }
 
 void Application::toggleFramerateDisplay()
 {
-    // To be implemented (call setDisplayFramerate)
+    Application::setDisplayFramerate(!Application::framerateDisplayed);
+}
+
+void Application::drawFramerate(NVGcontext* vg)
+{
+    std::vector<std::string> lines = { fmt::format("{:.1f} FPS", Application::framePacer.getFramerate()) };
+
+    if (MemoryTracker::isOverlayEnabled())
+    {
+        const std::vector<std::string>& memoryLines = MemoryTracker::getOverlayLines();
+        lines.insert(lines.end(), memoryLines.begin(), memoryLines.end());
+    }
+
+    float fontSize   = 16.0f;
+    float lineHeight = 20.0f;
+    float padding    = 6.0f;
+
+    nvgFontFaceId(vg, Application::getFont(FONT_REGULAR));
+    nvgFontSize(vg, fontSize);
+    nvgTextAlign(vg, NVG_ALIGN_LEFT | NVG_ALIGN_TOP);
+
+    float width = 0.0f;
+    for (std::string& line : lines)
+        width = std::max(width, nvgTextBounds(vg, 0, 0, line.c_str(), nullptr, nullptr));
+
+    nvgBeginPath(vg);
+    nvgFillColor(vg, nvgRGBA(0, 0, 0, 160));
+    nvgRect(vg, 0, 0, width + padding * 2, lineHeight * lines.size() + padding * 2);
+    nvgFill(vg);
+
+    nvgFillColor(vg, nvgRGB(255, 255, 255));
+    for (size_t i = 0; i < lines.size(); i++)
+        nvgText(vg, padding, padding + lineHeight * i, lines[i].c_str(), nullptr);
 }
 
 ActionIdentifier Application::registerFPSToggleAction(Activity* activity)
@@ -530,6 +728,12 @@ ActionIdentifier Application::registerFPSToggleAction(Activity* activity)
         "FPS", BUTTON_BACK, [](View* view) { Application::toggleFramerateDisplay(); return true; }, true);
 }
 
+ActionIdentifier Application::registerMemoryDumpAction(Activity* activity)
+{
+    return activity->registerAction(
+        "Memory", BUTTON_RSB, [](View* view) { MemoryTracker::log(); return true; }, true);
+}
+
 void Application::setGlobalQuit(bool enabled)
 {
     Application::globalQuitEnabled = enabled;
@@ -554,6 +758,18 @@ void Application::setGlobalFPSToggle(bool enabled)
     }
 }
 
+void Application::setGlobalMemoryDump(bool enabled)
+{
+    Application::globalMemoryDumpEnabled = enabled;
+    for (auto it = Application::activitiesStack.begin(); it != Application::activitiesStack.end(); ++it)
+    {
+        if (enabled)
+            Application::globalMemoryDumpIdentifier = Application::registerMemoryDumpAction(*it);
+        else
+            (*it)->unregisterAction(Application::globalMemoryDumpIdentifier);
+    }
+}
+
 void Application::notify(std::string text)
 {
     // To be implemented
@@ -575,13 +791,15 @@ void Application::giveFocus(View* view)
         if (newFocus)
         {
             newFocus->onFocusGained();
-            Logger::debug("Giving focus to {}", newFocus->describe());
+            BRLS_LOG_DEBUG("Giving focus to {}", newFocus->describe());
         }
     }
 }
 
 void Application::popActivity(TransitionAnimation animation, std::function<void(void)> cb)
 {
+    BRLS_TRACE_SCOPE("popActivity");
+
     if (Application::activitiesStack.size() <= 1) // never pop the first activity
         return;
 
@@ -634,20 +852,64 @@ void Application::popActivity(TransitionAnimation animation, std::function<void(
     {
         View* newFocus = Application::focusStack[Application::focusStack.size() - 1];
 
-        Logger::debug("Giving focus to {}, and removing it from the focus stack", newFocus->describe());
+        BRLS_LOG_DEBUG("Giving focus to {}, and removing it from the focus stack", newFocus->describe());
 
         Application::giveFocus(newFocus);
         Application::focusStack.pop_back();
     }
 }
 
+void Application::preloadActivity(Activity* activity)
+{
+    if (activity->isContentLoaded())
+        return;
+
+    if (std::find(Application::preloadQueue.begin(), Application::preloadQueue.end(), activity) == Application::preloadQueue.end())
+        Application::preloadQueue.push_back(activity);
+}
+
+void Application::cancelActivityPreload(Activity* activity)
+{
+    auto it = std::find(Application::preloadQueue.begin(), Application::preloadQueue.end(), activity);
+
+    if (it != Application::preloadQueue.end())
+        Application::preloadQueue.erase(it);
+}
+
+void Application::preloadNextActivity()
+{
+    if (Application::preloadQueue.empty() || Application::blockInputsTokens != 0 || Application::inputThisFrame)
+        return;
+
+    Activity* activity = Application::preloadQueue.front();
+    Application::preloadQueue.pop_front();
+
+    Time start = getCPUTimeUsec();
+
+    activity->loadContent();
+
+    BRLS_LOG_DEBUG("Preloaded activity in {:.2f}ms ({} left)", (float)(getCPUTimeUsec() - start) / 1000.0f, Application::preloadQueue.size());
+}
+
+size_t Application::getActivitiesCount()
+{
+    return Application::activitiesStack.size();
+}
+
+size_t Application::getFocusStackSize()
+{
+    return Application::focusStack.size();
+}
+
 void Application::pushActivity(Activity* activity, TransitionAnimation animation)
 {
+    BRLS_TRACE_SCOPE("pushActivity");
+
     Application::blockInputs();
 
-    // Create the activity content view
-    activity->setContentView(activity->createContentView());
-    activity->onContentAvailable();
+    // Create the activity content view, unless it's preloaded
+    Application::cancelActivityPreload(activity);
+    activity->loadContent();
 
     // Call hide() on the previous activity in the stack if no
     // activities are translucent, then call show() once the animation ends
@@ -664,6 +926,9 @@ void Application::pushActivity(Activity* activity, TransitionAnimation animation
     if (Application::globalFPSToggleEnabled)
         Application::gloablFPSToggleIdentifier = Application::registerFPSToggleAction(activity);
 
+    if (Application::globalMemoryDumpEnabled)
+        Application::globalMemoryDumpIdentifier = Application::registerMemoryDumpAction(activity);
+
     // Fade out animation
     if (fadeOut)
     {
@@ -700,7 +965,7 @@ void Application::pushActivity(Activity* activity, TransitionAnimation animation
     // Focus
     if (Application::activitiesStack.size() > 0 && Application::currentFocus != nullptr)
     {
-        Logger::debug("Pushing {} to the focus stack", Application::currentFocus->describe());
+        BRLS_LOG_DEBUG("Pushing {} to the focus stack", Application::currentFocus->describe());
         Application::focusStack.push_back(Application::currentFocus);
     }
 
@@ -725,9 +990,17 @@ void Application::clear()
 
 Theme &Application::getTheme()
 {
+    // Stylesheets might still be parsed in the background on startup
+    Application::startup.wait(Application::stylesheetsStep);
     return *theme;
 }
 
+Style Application::getStyle()
+{
+    Application::startup.wait(Application::stylesheetsStep);
+    return *style;
+}
+
 ThemeVariant Application::getThemeVariant()
 {
     return Application::platform->getThemeVariant();
@@ -774,7 +1047,7 @@ void Application::crash(std::string text)
 void Application::blockInputs()
 {
     Application::blockInputsTokens += 1;
-    Logger::debug("Adding an inputs block token (tokens={})", Application::blockInputsTokens);
+    BRLS_LOG_DEBUG("Adding an inputs block token (tokens={})", Application::blockInputsTokens);
 }
 
 void Application::unblockInputs()
@@ -782,7 +1055,7 @@ void Application::unblockInputs()
     if (Application::blockInputsTokens > 0)
         Application::blockInputsTokens -= 1;
 
-    Logger::debug("Removing an inputs block token (tokens={})", Application::blockInputsTokens);
+    BRLS_LOG_DEBUG("Removing an inputs block token (tokens={})", Application::blockInputsTokens);
 }
 
 NVGcontext* Application::getNVGContext()
@@ -817,7 +1090,7 @@ void Application::onWindowResized(int width, int height)
     Logger::info("New scale factor is {}", Application::windowScale);
 
     // Trigger a layout
-    Logger::debug("Layout triggered");
+    BRLS_LOG_DEBUG("Layout triggered");
 
     for (Activity* activity : Application::activitiesStack)
         activity->onWindowSizeChanged();
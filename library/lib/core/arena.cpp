@@ -0,0 +1,195 @@
+/*
+    Copyright 2021 natinusala
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+#include <stdlib.h>
+
+#include <borealis/core/arena.hpp>
+#include <borealis/core/logger.hpp>
+
+namespace brls
+{
+
+// The memory of an arena, referenced by every allocation made in it
+struct ArenaBlocks
+{
+    std::vector<char*> blocks;
+    size_t live   = 0;
+    bool orphaned = false; // the arena was deleted with allocations still alive
+
+    ~ArenaBlocks()
+    {
+        for (char* block : this->blocks)
+            free(block);
+    }
+};
+
+// Every allocation starts with a header telling where it comes from,
+// padded to keep the memory aligned for any type
+struct alignas(alignof(std::max_align_t)) ArenaHeader
+{
+    ArenaBlocks* blocks; // nullptr if on the heap
+};
+
+static constexpr size_t ALIGNMENT = alignof(std::max_align_t);
+
+static size_t alignSize(size_t size)
+{
+    return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+}
+
+Arena::Arena(size_t blockSize)
+    : blockSize(blockSize)
+    , blocks(new ArenaBlocks())
+{
+}
+
+Arena::~Arena()
+{
+    if (this->blocks->live > 0)
+    {
+        // The last deallocation gives the blocks back
+        Logger::warning("Arena deleted with {} allocations still alive, keeping its {} bytes", this->blocks->live, this->size);
+        this->blocks->orphaned = true;
+        return;
+    }
+
+    delete this->blocks;
+}
+
+void* Arena::bump(size_t size)
+{
+    size = alignSize(size);
+
+    if (this->cursor == nullptr || (size_t)(this->end - this->cursor) < size)
+    {
+        // Allocations larger than a block get their own
+        size_t blockSize = size > this->blockSize ? size : this->blockSize;
+        char* block      = (char*)malloc(blockSize);
+
+        if (!block)
+            return nullptr;
+
+        this->blocks->blocks.push_back(block);
+        this->size += blockSize;
+
+        // Keep filling the current block if the new one was only for a large allocation
+        if (blockSize > this->blockSize && this->cursor != nullptr)
+            return block;
+
+        this->cursor = block;
+        this->end    = block + blockSize;
+    }
+
+    void* memory = this->cursor;
+    this->cursor += size;
+    return memory;
+}
+
+size_t Arena::getSize()
+{
+    return this->size;
+}
+
+size_t Arena::getLiveAllocations()
+{
+    return this->blocks->live;
+}
+
+void* Arena::allocate(size_t size)
+{
+    Arena* arena = Arena::current;
+    ArenaHeader* header;
+
+    if (arena)
+        header = (ArenaHeader*)arena->bump(sizeof(ArenaHeader) + size);
+    else
+        header = (ArenaHeader*)malloc(sizeof(ArenaHeader) + size);
+
+    if (!header)
+        return nullptr;
+
+    header->blocks = arena ? arena->blocks : nullptr;
+
+    if (arena)
+        arena->blocks->live++;
+
+    return header + 1;
+}
+
+void Arena::deallocate(void* memory)
+{
+    if (!memory)
+        return;
+
+    ArenaHeader* header = (ArenaHeader*)memory - 1;
+
+    // Arena memory is given back with the whole arena
+    if (header->blocks)
+    {
+        ArenaBlocks* blocks = header->blocks;
+        blocks->live--;
+
+        if (blocks->orphaned && blocks->live == 0)
+            delete blocks;
+    }
+    else
+    {
+        free(header);
+    }
+}
+
+Arena* Arena::getCurrent()
+{
+    return Arena::current;
+}
+
+static void* allocateYogaNode(YGConfigRef config, size_t size)
+{
+    return Arena::allocate(size);
+}
+
+static void deallocateYogaNode(YGConfigRef config, void* memory)
+{
+    Arena::deallocate(memory);
+}
+
+YGConfigRef Arena::getYogaConfig()
+{
+    static YGConfigRef config = nullptr;
+
+    if (!config)
+    {
+        config = YGConfigNew();
+        YGConfigCopy(config, YGConfigGetDefault());
+        YGConfigSetNodeAllocator(config, allocateYogaNode, deallocateYogaNode);
+    }
+
+    return config;
+}
+
+ArenaScope::ArenaScope(Arena* arena)
+    : previous(Arena::current)
+{
+    Arena::current = arena;
+}
+
+ArenaScope::~ArenaScope()
+{
+    Arena::current = this->previous;
+}
+
+} // namespace brls
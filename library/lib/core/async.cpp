@@ -0,0 +1,288 @@
+/*
+    Copyright 2021 natinusala
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <borealis/core/async.hpp>
+#include <borealis/core/logger.hpp>
+#include <borealis/core/trace.hpp>
+#include <shared_mutex>
+#include <stdexcept>
+
+namespace brls
+{
+
+// Index of the worker running on the current thread, -1 if it's not a worker
+static thread_local int currentWorker = -1;
+
+enum class PoolState
+{
+    NOT_STARTED,
+    RUNNING,
+    STOPPING,
+    STOPPED,
+};
+
+// Exclusive to start or stop the pool, shared to submit tasks to the workers
+static std::shared_mutex poolMutex;
+static PoolState poolState = PoolState::NOT_STARTED;
+
+CancellationToken::CancellationToken(std::shared_ptr<std::atomic<bool>> state)
+    : state(state)
+{
+}
+
+bool CancellationToken::isCancelled() const
+{
+    return this->state && this->state->load(std::memory_order_acquire);
+}
+
+CancellationSource::CancellationSource()
+    : state(std::make_shared<std::atomic<bool>>(false))
+{
+}
+
+CancellationSource::~CancellationSource()
+{
+    this->cancel();
+}
+
+void CancellationSource::cancel()
+{
+    this->state->store(true, std::memory_order_release);
+}
+
+bool CancellationSource::isCancelled() const
+{
+    return this->state->load(std::memory_order_acquire);
+}
+
+CancellationToken CancellationSource::getToken() const
+{
+    return CancellationToken(this->state);
+}
+
+void TaskPool::start(unsigned workers)
+{
+    std::unique_lock<std::shared_mutex> lock(poolMutex);
+
+    if (poolState == PoolState::RUNNING || poolState == PoolState::STOPPING)
+        return;
+
+    if (workers == 0)
+    {
+        unsigned threads = std::thread::hardware_concurrency();
+        workers          = threads > 2 ? threads - 1 : 1;
+    }
+
+    for (unsigned i = 0; i < workers; i++)
+        TaskPool::workers.push_back(std::make_unique<Worker>());
+
+    TaskPool::running = true;
+    poolState         = PoolState::RUNNING;
+
+    for (unsigned i = 0; i < workers; i++)
+        TaskPool::workers[i]->thread = std::thread(TaskPool::workerMain, i);
+
+    BRLS_LOG_DEBUG("Started task pool with {} workers", workers);
+}
+
+void TaskPool::stop()
+{
+    {
+        std::unique_lock<std::shared_mutex> lock(poolMutex);
+
+        if (poolState != PoolState::RUNNING)
+            return;
+
+        poolState = PoolState::STOPPING;
+
+        {
+            std::lock_guard<std::mutex> sleepLock(TaskPool::sleepMutex);
+            TaskPool::running = false;
+        }
+
+        TaskPool::sleepCondition.notify_all();
+    }
+
+    // Without the lock, since running tasks can still try to submit: the workers
+    // list cannot change while STOPPING, and these submits are rejected
+    for (std::unique_ptr<Worker>& worker : TaskPool::workers)
+        worker->thread.join();
+
+    std::unique_lock<std::shared_mutex> lock(poolMutex);
+
+    TaskPool::workers.clear();
+    TaskPool::pendingTasks = 0;
+
+    poolState = PoolState::STOPPED;
+}
+
+void TaskPool::submit(AsyncTask task)
+{
+    std::shared_lock<std::shared_mutex> lock(poolMutex);
+
+    // Start on first use only: once stopped, the pool only restarts with start()
+    if (poolState == PoolState::NOT_STARTED)
+    {
+        lock.unlock();
+        TaskPool::start();
+        lock.lock();
+    }
+
+    if (poolState != PoolState::RUNNING)
+    {
+        Logger::warning("Task submitted to a stopped task pool, discarding it");
+        return;
+    }
+
+    // Workers push to their own queue, other threads spread the tasks
+    unsigned index;
+    if (currentWorker >= 0)
+        index = (unsigned)currentWorker;
+    else
+        index = TaskPool::nextWorker++ % TaskPool::workers.size();
+
+    Worker* worker = TaskPool::workers[index].get();
+
+    {
+        std::lock_guard<std::mutex> workerLock(worker->mutex);
+        worker->tasks.push_back(std::move(task));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(TaskPool::sleepMutex);
+        TaskPool::pendingTasks++;
+    }
+
+    TaskPool::sleepCondition.notify_one();
+}
+
+bool TaskPool::popTask(unsigned index, AsyncTask* task)
+{
+    // Own queue first, newest task to keep caches warm
+    {
+        Worker* worker = TaskPool::workers[index].get();
+        std::lock_guard<std::mutex> lock(worker->mutex);
+
+        if (!worker->tasks.empty())
+        {
+            *task = std::move(worker->tasks.back());
+            worker->tasks.pop_back();
+            return true;
+        }
+    }
+
+    // Then steal the oldest task of another worker
+    size_t count = TaskPool::workers.size();
+    for (size_t i = 1; i < count; i++)
+    {
+        Worker* victim = TaskPool::workers[(index + i) % count].get();
+        std::lock_guard<std::mutex> lock(victim->mutex);
+
+        if (!victim->tasks.empty())
+        {
+            *task = std::move(victim->tasks.front());
+            victim->tasks.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void TaskPool::workerMain(unsigned index)
+{
+    currentWorker = (int)index;
+
+    BRLS_TRACE_THREAD_NAME("worker");
+
+    while (TaskPool::running)
+    {
+        AsyncTask task;
+
+        if (TaskPool::popTask(index, &task))
+        {
+            TaskPool::pendingTasks--;
+
+            try
+            {
+                BRLS_TRACE_SCOPE("task");
+                task();
+            }
+            catch (const std::exception& e)
+            {
+                Logger::error("Uncaught exception in background task: {}", e.what());
+            }
+
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(TaskPool::sleepMutex);
+        TaskPool::sleepCondition.wait(lock, [] { return !TaskPool::running || TaskPool::pendingTasks > 0; });
+    }
+}
+
+void TaskPool::submitToMainThread(AsyncTask task)
+{
+    TaskPool::mainThreadTasks.push(std::move(task));
+}
+
+void TaskPool::processMainThreadTasks()
+{
+    // Take the tasks first so that the tasks queued by these tasks
+    // run next frame instead of looping forever
+    std::vector<AsyncTask> tasks;
+    AsyncTask task;
+
+    while (TaskPool::mainThreadTasks.pop(&task))
+        tasks.push_back(std::move(task));
+
+    for (AsyncTask& mainThreadTask : tasks)
+        mainThreadTask();
+}
+
+unsigned TaskPool::getWorkersCount()
+{
+    std::shared_lock<std::shared_mutex> lock(poolMutex);
+    return TaskPool::workers.size();
+}
+
+void async(AsyncTask task)
+{
+    TaskPool::submit(std::move(task));
+}
+
+void async(CancellationToken token, AsyncTask task)
+{
+    TaskPool::submit([token, task]() {
+        if (!token.isCancelled())
+            task();
+    });
+}
+
+void sync(AsyncTask task)
+{
+    TaskPool::submitToMainThread(std::move(task));
+}
+
+void sync(CancellationToken token, AsyncTask task)
+{
+    TaskPool::submitToMainThread([token, task]() {
+        if (!token.isCancelled())
+            task();
+    });
+}
+
+} // namespace brls
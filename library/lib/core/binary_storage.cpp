@@ -0,0 +1,770 @@
+/*
+    Copyright 2021 natinusala
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <array>
+#include <borealis/core/binary_storage.hpp>
+#include <borealis/core/logger.hpp>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+#if !defined(__SWITCH__) && __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define BRLS_MMAP
+#endif
+
+// File header: magic, version (uint32), reserved (uint32)
+#define FILE_MAGIC "BRLSLIST"
+#define FILE_VERSION 1
+#define FILE_HEADER_SIZE 16
+
+// Record header: magic (uint32), type (uint8), flags (uint8), name length (uint16),
+// count (uint32), payload size (uint32), checksum (uint32), reserved (uint32)
+// followed by the name and the payload, both padded to 4 bytes
+#define RECORD_MAGIC 0x4345524C // "LREC"
+#define RECORD_HEADER_SIZE 24
+#define RECORD_FLAG_EXTEND 0x01
+
+// Compact the file when it's bigger than this and more than half of it is outdated
+#define COMPACT_MIN_SIZE (64 * 1024)
+
+namespace brls
+{
+
+static size_t align4(size_t size)
+{
+    return (size + 3) & ~(size_t)3;
+}
+
+static uint16_t load16(const uint8_t* data)
+{
+    return (uint16_t)(data[0] | (data[1] << 8));
+}
+
+static uint32_t load32(const uint8_t* data)
+{
+    return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+static void store16(uint8_t* data, uint16_t value)
+{
+    data[0] = (uint8_t)value;
+    data[1] = (uint8_t)(value >> 8);
+}
+
+static void store32(uint8_t* data, uint32_t value)
+{
+    data[0] = (uint8_t)value;
+    data[1] = (uint8_t)(value >> 8);
+    data[2] = (uint8_t)(value >> 16);
+    data[3] = (uint8_t)(value >> 24);
+}
+
+static uint32_t crc32(uint32_t crc, const uint8_t* data, size_t size)
+{
+    static const std::array<uint32_t, 256> table = [] {
+        std::array<uint32_t, 256> table;
+
+        for (uint32_t i = 0; i < 256; i++)
+        {
+            uint32_t value = i;
+            for (int bit = 0; bit < 8; bit++)
+                value = (value & 1) ? 0xEDB88320 ^ (value >> 1) : value >> 1;
+
+            table[i] = value;
+        }
+
+        return table;
+    }();
+
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++)
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+
+    return ~crc;
+}
+
+static bool readInMemory(const std::string& path, std::vector<uint8_t>& buffer)
+{
+    FILE* file = fopen(path.c_str(), "rb");
+
+    if (!file)
+        return false;
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    bool success = size >= 0;
+
+    if (success)
+    {
+        buffer.resize((size_t)size);
+        success = fread(buffer.data(), 1, buffer.size(), file) == buffer.size();
+    }
+
+    fclose(file);
+    return success;
+}
+
+MappedFile::~MappedFile()
+{
+    this->close();
+}
+
+bool MappedFile::open(const std::string& path)
+{
+    this->close();
+
+#ifdef BRLS_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    // Empty files cannot be mapped
+    if (st.st_size == 0)
+    {
+        ::close(fd);
+        return true;
+    }
+
+    void* address = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+
+    if (address != MAP_FAILED)
+    {
+        this->data   = (const uint8_t*)address;
+        this->size   = (size_t)st.st_size;
+        this->mapped = true;
+        return true;
+    }
+#endif
+
+    if (!readInMemory(path, this->buffer))
+        return false;
+
+    this->data = this->buffer.data();
+    this->size = this->buffer.size();
+    return true;
+}
+
+void MappedFile::close()
+{
+#ifdef BRLS_MMAP
+    if (this->mapped)
+        munmap((void*)this->data, this->size);
+#endif
+
+    this->buffer.clear();
+    this->buffer.shrink_to_fit();
+
+    this->data   = nullptr;
+    this->size   = 0;
+    this->mapped = false;
+}
+
+const uint8_t* MappedFile::getData()
+{
+    return this->data;
+}
+
+size_t MappedFile::getSize()
+{
+    return this->size;
+}
+
+template <typename T>
+struct BinaryListTraits;
+
+template <>
+struct BinaryListTraits<int>
+{
+    static constexpr BinaryListType TYPE = BinaryListType::INT;
+};
+
+template <>
+struct BinaryListTraits<float>
+{
+    static constexpr BinaryListType TYPE = BinaryListType::FLOAT;
+};
+
+template <>
+struct BinaryListTraits<bool>
+{
+    static constexpr BinaryListType TYPE = BinaryListType::BOOL;
+};
+
+template <>
+struct BinaryListTraits<std::string>
+{
+    static constexpr BinaryListType TYPE = BinaryListType::STRING;
+};
+
+static void decode(const uint8_t* payload, uint32_t count, std::vector<int>& values)
+{
+    for (uint32_t i = 0; i < count; i++)
+        values.push_back((int32_t)load32(payload + i * 4));
+}
+
+static void decode(const uint8_t* payload, uint32_t count, std::vector<float>& values)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint32_t bits = load32(payload + i * 4);
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        values.push_back(value);
+    }
+}
+
+static void decode(const uint8_t* payload, uint32_t count, std::vector<bool>& values)
+{
+    for (uint32_t i = 0; i < count; i++)
+        values.push_back(payload[i] != 0);
+}
+
+static void decode(const uint8_t* payload, uint32_t count, std::vector<std::string>& values)
+{
+    const char* characters = (const char*)payload + (count + 1) * 4;
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint32_t start = load32(payload + i * 4);
+        uint32_t end   = load32(payload + (i + 1) * 4);
+        values.emplace_back(characters + start, end - start);
+    }
+}
+
+static void encode(const std::vector<int>& values, size_t from, std::vector<uint8_t>& payload)
+{
+    payload.resize((values.size() - from) * 4);
+
+    for (size_t i = from; i < values.size(); i++)
+        store32(payload.data() + (i - from) * 4, (uint32_t)(int32_t)values[i]);
+}
+
+static void encode(const std::vector<float>& values, size_t from, std::vector<uint8_t>& payload)
+{
+    payload.resize((values.size() - from) * 4);
+
+    for (size_t i = from; i < values.size(); i++)
+    {
+        uint32_t bits;
+        memcpy(&bits, &values[i], sizeof(bits));
+        store32(payload.data() + (i - from) * 4, bits);
+    }
+}
+
+static void encode(const std::vector<bool>& values, size_t from, std::vector<uint8_t>& payload)
+{
+    payload.resize(values.size() - from);
+
+    for (size_t i = from; i < values.size(); i++)
+        payload[i - from] = values[i] ? 1 : 0;
+}
+
+static void encode(const std::vector<std::string>& values, size_t from, std::vector<uint8_t>& payload)
+{
+    size_t count = values.size() - from;
+    size_t table = (count + 1) * 4;
+    size_t size  = table;
+
+    for (size_t i = from; i < values.size(); i++)
+        size += values[i].size();
+
+    payload.resize(size);
+
+    uint32_t offset = 0;
+    for (size_t i = from; i < values.size(); i++)
+    {
+        store32(payload.data() + (i - from) * 4, offset);
+        memcpy(payload.data() + table + offset, values[i].data(), values[i].size());
+        offset += (uint32_t)values[i].size();
+    }
+
+    store32(payload.data() + count * 4, offset);
+}
+
+// Checks that the payload of a record matches its count, so that it can be decoded blindly
+static bool isPayloadValid(BinaryListType type, const uint8_t* payload, uint32_t count, uint32_t size)
+{
+    switch (type)
+    {
+        case BinaryListType::INT:
+        case BinaryListType::FLOAT:
+            return (uint64_t)count * 4 == size;
+        case BinaryListType::BOOL:
+            return count == size;
+        case BinaryListType::STRING:
+        {
+            uint64_t table = ((uint64_t)count + 1) * 4;
+            if (table > size)
+                return false;
+
+            uint32_t previous = 0;
+            for (uint32_t i = 0; i <= count; i++)
+            {
+                uint32_t offset = load32(payload + i * 4);
+                if (offset < previous || table + offset > size)
+                    return false;
+
+                previous = offset;
+            }
+
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+static void buildRecord(const std::string& name, BinaryListType type, bool extend, uint32_t count, const std::vector<uint8_t>& payload, std::vector<uint8_t>& record)
+{
+    size_t start = record.size();
+    record.resize(start + RECORD_HEADER_SIZE + align4(name.size()) + align4(payload.size()), 0);
+
+    uint8_t* header = record.data() + start;
+    store32(header, RECORD_MAGIC);
+    header[4] = (uint8_t)type;
+    header[5] = extend ? RECORD_FLAG_EXTEND : 0;
+    store16(header + 6, (uint16_t)name.size());
+    store32(header + 8, count);
+    store32(header + 12, (uint32_t)payload.size());
+
+    uint8_t* nameData    = header + RECORD_HEADER_SIZE;
+    uint8_t* payloadData = nameData + align4(name.size());
+    memcpy(nameData, name.data(), name.size());
+    memcpy(payloadData, payload.data(), payload.size());
+
+    uint32_t checksum = crc32(0, header + 4, 12);
+    checksum          = crc32(checksum, nameData, name.size());
+    checksum          = crc32(checksum, payloadData, payload.size());
+    store32(header + 16, checksum);
+}
+
+static void buildFileHeader(std::vector<uint8_t>& content)
+{
+    content.resize(FILE_HEADER_SIZE, 0);
+    memcpy(content.data(), FILE_MAGIC, 8);
+    store32(content.data() + 8, FILE_VERSION);
+}
+
+bool BinaryListFile::open(std::string path)
+{
+    this->path = path;
+    this->lists.clear();
+    this->fileSize = 0;
+
+    this->opened = this->load();
+    return this->opened;
+}
+
+bool BinaryListFile::load()
+{
+    if (!std::filesystem::exists(this->path))
+        return true;
+
+    if (!this->file.open(this->path))
+    {
+        Logger::error("BinaryListFile: Could not open {}.", this->path);
+        return false;
+    }
+
+    this->stale = false;
+
+    const uint8_t* data = this->file.getData();
+    size_t size         = this->file.getSize();
+
+    // Empty file, nothing written yet
+    if (size == 0)
+        return true;
+
+    if (size < FILE_HEADER_SIZE || memcmp(data, FILE_MAGIC, 8) != 0)
+    {
+        Logger::error("BinaryListFile: {} is not a list file, it will not be written to.", this->path);
+        return false;
+    }
+
+    uint32_t version = load32(data + 8);
+    if (version != FILE_VERSION)
+    {
+        Logger::error("BinaryListFile: {} has unsupported version {}, it will not be written to.", this->path, version);
+        return false;
+    }
+
+    size_t offset = FILE_HEADER_SIZE;
+    while (offset + RECORD_HEADER_SIZE <= size)
+    {
+        const uint8_t* header = data + offset;
+
+        if (load32(header) != RECORD_MAGIC)
+            break;
+
+        BinaryListType type  = (BinaryListType)header[4];
+        bool extend          = header[5] & RECORD_FLAG_EXTEND;
+        uint16_t nameLength  = load16(header + 6);
+        uint32_t count       = load32(header + 8);
+        uint32_t payloadSize = load32(header + 12);
+        uint32_t checksum    = load32(header + 16);
+
+        size_t nameOffset    = offset + RECORD_HEADER_SIZE;
+        size_t payloadOffset = nameOffset + align4(nameLength);
+        size_t end           = payloadOffset + align4(payloadSize);
+
+        if (end > size)
+            break;
+
+        uint32_t computed = crc32(0, header + 4, 12);
+        computed          = crc32(computed, data + nameOffset, nameLength);
+        computed          = crc32(computed, data + payloadOffset, payloadSize);
+
+        if (computed != checksum || !isPayloadValid(type, data + payloadOffset, count, payloadSize))
+            break;
+
+        List& list = this->lists[std::string((const char*)data + nameOffset, nameLength)];
+
+        if (!extend || list.type != type)
+        {
+            list.type = type;
+            list.segments.clear();
+            list.count = 0;
+            list.size  = 0;
+        }
+
+        list.segments.push_back({ payloadOffset, count, payloadSize });
+        list.count += count;
+        list.size += end - offset;
+
+        offset = end;
+    }
+
+    // Anything after the last valid record is a write that did not complete,
+    // it will be overwritten by the next write
+    if (offset < size)
+        Logger::warning("BinaryListFile: Ignoring {} bytes of incomplete or corrupted data at the end of {}.", size - offset, this->path);
+
+    this->fileSize = offset;
+    return true;
+}
+
+const uint8_t* BinaryListFile::getData()
+{
+    if (this->stale)
+    {
+        if (!this->file.open(this->path))
+            Logger::error("BinaryListFile: Could not open {}.", this->path);
+
+        this->stale = false;
+    }
+
+    return this->file.getData();
+}
+
+BinaryListFile::List* BinaryListFile::getList(const std::string& name, BinaryListType type)
+{
+    auto it = this->lists.find(name);
+
+    if (it == this->lists.end() || it->second.type != type)
+        return nullptr;
+
+    return &it->second;
+}
+
+template <typename T>
+bool BinaryListFile::readList(const std::string& name, std::vector<T>& values)
+{
+    values.clear();
+
+    List* list = this->getList(name, BinaryListTraits<T>::TYPE);
+    if (!list)
+        return false;
+
+    const uint8_t* data = this->getData();
+    if (!data && list->count > 0)
+        return false;
+
+    values.reserve(list->count);
+
+    for (const Segment& segment : list->segments)
+    {
+        if (segment.offset + segment.size > this->file.getSize())
+            return false;
+
+        decode(data + segment.offset, segment.count, values);
+    }
+
+    return true;
+}
+
+template <typename T>
+bool BinaryListFile::writeList(const std::string& name, const std::vector<T>& values)
+{
+    if (!this->opened)
+    {
+        Logger::error("BinaryListFile: Cannot write list {}, {} could not be opened.", name, this->path);
+        return false;
+    }
+
+    if (name.size() > UINT16_MAX || values.size() > UINT32_MAX)
+    {
+        Logger::error("BinaryListFile: List {} is too big to be saved.", name);
+        return false;
+    }
+
+    std::vector<uint8_t> payload;
+
+    // Only write the new values if the list was only appended to
+    List* list = this->getList(name, BinaryListTraits<T>::TYPE);
+    if (list && list->count <= values.size())
+    {
+        std::vector<T> stored;
+
+        if (this->readList(name, stored) && std::equal(stored.begin(), stored.end(), values.begin()))
+        {
+            if (stored.size() == values.size())
+                return true; // unchanged
+
+            encode(values, stored.size(), payload);
+            return this->append(name, BinaryListTraits<T>::TYPE, true, (uint32_t)(values.size() - stored.size()), payload);
+        }
+    }
+
+    encode(values, 0, payload);
+    return this->append(name, BinaryListTraits<T>::TYPE, false, (uint32_t)values.size(), payload);
+}
+
+bool BinaryListFile::append(const std::string& name, BinaryListType type, bool extend, uint32_t count, const std::vector<uint8_t>& payload)
+{
+    if (payload.size() > UINT32_MAX)
+    {
+        Logger::error("BinaryListFile: List {} is too big to be saved.", name);
+        return false;
+    }
+
+    std::vector<uint8_t> content;
+    if (this->fileSize == 0)
+        buildFileHeader(content);
+
+    size_t recordOffset = this->fileSize + content.size();
+    buildRecord(name, type, extend, count, payload, content);
+
+    FILE* file;
+    if (this->fileSize == 0)
+    {
+        file = fopen(this->path.c_str(), "wb");
+    }
+    else
+    {
+        // Drop what a previous incomplete write left behind
+        std::error_code error;
+        if (std::filesystem::file_size(this->path, error) != this->fileSize)
+            std::filesystem::resize_file(this->path, this->fileSize, error);
+
+        file = fopen(this->path.c_str(), "ab");
+    }
+
+    if (!file)
+    {
+        Logger::error("BinaryListFile: Could not open {} for writing.", this->path);
+        return false;
+    }
+
+    bool success = fwrite(content.data(), 1, content.size(), file) == content.size();
+    success      = fflush(file) == 0 && success;
+    fclose(file);
+
+    this->stale = true;
+
+    if (!success)
+    {
+        Logger::error("BinaryListFile: Could not write list {} to {}.", name, this->path);
+        return false;
+    }
+
+    List& list = this->lists[name];
+
+    if (!extend)
+    {
+        list.type = type;
+        list.segments.clear();
+        list.count = 0;
+        list.size  = 0;
+    }
+
+    size_t payloadOffset = recordOffset + RECORD_HEADER_SIZE + align4(name.size());
+    list.segments.push_back({ payloadOffset, count, (uint32_t)payload.size() });
+    list.count += count;
+    list.size += this->fileSize + content.size() - recordOffset;
+
+    this->fileSize += content.size();
+
+    this->onListWritten();
+    return true;
+}
+
+void BinaryListFile::onListWritten()
+{
+    size_t live = FILE_HEADER_SIZE;
+    for (auto& [name, list] : this->lists)
+        live += list.size;
+
+    if (this->fileSize > COMPACT_MIN_SIZE && live * 2 < this->fileSize)
+        this->compact();
+}
+
+bool BinaryListFile::compact()
+{
+    if (!this->opened)
+        return false;
+
+    std::vector<uint8_t> content;
+    buildFileHeader(content);
+
+    std::vector<uint8_t> payload;
+    for (auto& [name, list] : this->lists)
+    {
+        switch (list.type)
+        {
+            case BinaryListType::INT:
+            {
+                std::vector<int> values;
+                this->readList(name, values);
+                encode(values, 0, payload);
+                break;
+            }
+            case BinaryListType::FLOAT:
+            {
+                std::vector<float> values;
+                this->readList(name, values);
+                encode(values, 0, payload);
+                break;
+            }
+            case BinaryListType::BOOL:
+            {
+                std::vector<bool> values;
+                this->readList(name, values);
+                encode(values, 0, payload);
+                break;
+            }
+            case BinaryListType::STRING:
+            {
+                std::vector<std::string> values;
+                this->readList(name, values);
+                encode(values, 0, payload);
+                break;
+            }
+            default:
+                continue;
+        }
+
+        buildRecord(name, list.type, false, (uint32_t)list.count, payload, content);
+    }
+
+    std::string tempPath = this->path + ".tmp";
+    FILE* file           = fopen(tempPath.c_str(), "wb");
+
+    if (!file)
+    {
+        Logger::error("BinaryListFile: Could not open {} for writing.", tempPath);
+        return false;
+    }
+
+    bool success = fwrite(content.data(), 1, content.size(), file) == content.size();
+    success      = fflush(file) == 0 && success;
+    fclose(file);
+
+    if (!success)
+    {
+        Logger::error("BinaryListFile: Could not write to {}.", tempPath);
+        std::remove(tempPath.c_str());
+        return false;
+    }
+
+    // Unmap before replacing the file
+    this->file.close();
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, this->path, error);
+
+    // Some file systems cannot rename over an existing file
+    if (error)
+    {
+        std::filesystem::remove(this->path, error);
+        std::filesystem::rename(tempPath, this->path, error);
+    }
+
+    if (error)
+        Logger::error("BinaryListFile: Could not rename {} to {}: {}.", tempPath, this->path, error.message());
+
+    this->lists.clear();
+    this->fileSize = 0;
+    this->opened   = this->load();
+
+    return !error;
+}
+
+bool BinaryListFile::read(const std::string& name, std::vector<int>& values)
+{
+    return this->readList(name, values);
+}
+
+bool BinaryListFile::read(const std::string& name, std::vector<float>& values)
+{
+    return this->readList(name, values);
+}
+
+bool BinaryListFile::read(const std::string& name, std::vector<bool>& values)
+{
+    return this->readList(name, values);
+}
+
+bool BinaryListFile::read(const std::string& name, std::vector<std::string>& values)
+{
+    return this->readList(name, values);
+}
+
+bool BinaryListFile::write(const std::string& name, const std::vector<int>& values)
+{
+    return this->writeList(name, values);
+}
+
+bool BinaryListFile::write(const std::string& name, const std::vector<float>& values)
+{
+    return this->writeList(name, values);
+}
+
+bool BinaryListFile::write(const std::string& name, const std::vector<bool>& values)
+{
+    return this->writeList(name, values);
+}
+
+bool BinaryListFile::write(const std::string& name, const std::vector<std::string>& values)
+{
+    return this->writeList(name, values);
+}
+
+} // namespace brls
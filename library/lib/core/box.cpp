@@ -19,6 +19,7 @@
 #include <borealis/core/application.hpp>
 #include <borealis/core/assets.hpp>
 #include <borealis/core/box.hpp>
+#include <borealis/core/trace.hpp>
 #include <borealis/core/util.hpp>
 #include <cmath>
 
@@ -104,6 +105,11 @@ Box::Box(Axis axis)
     this->registerFloatXMLAttribute("padding", [this](float value) {
         this->setPadding(value);
     });
+
+    // Navigation
+    this->registerBoolXMLAttribute("spatialNavigation", [this](bool value) {
+        this->setSpatialNavigationEnabled(value);
+    });
 }
 
 Box::Box()
@@ -112,6 +118,13 @@ Box::Box()
     // Empty ctor for XML
 }
 
+Box::~Box()
+{
+    // Children are owned by the box
+    for (View* child : this->children)
+        delete child;
+}
+
 void Box::getCullingBounds(float* top, float* right, float* bottom, float* left)
 {
     *top    = this->getY();
@@ -160,65 +173,200 @@ void Box::draw(NVGcontext* vg, float x, float y, float width, float height, Styl
     }
 }
 
+// Removes the IDs of the given view tree from the index, and adds them to the destination if there is one
+static void removeFromViewIndex(ViewIndex* index, View* view, ViewIndex* destination)
+{
+    if (view->getInternedId())
+    {
+        index->remove(view);
+
+        if (destination)
+            destination->add(view);
+    }
+
+    if (Box* box = dynamic_cast<Box*>(view))
+    {
+        for (View* child : box->getChildren())
+            removeFromViewIndex(index, child, destination);
+    }
+}
+
 void Box::addView(View* view)
 {
-    size_t position = YGNodeGetChildCount(this->ygNode);
-    this->addView(view, position);
+    this->addView(view, this->children.size());
 }
 
 void Box::addView(View* view, size_t position)
+{
+    this->insertChild(view, position);
+    this->updateChildrenIndices(position + 1);
+
+    // Layout and events
+    this->invalidate();
+    view->willAppear();
+}
+
+void Box::addViews(const std::vector<View*>& views)
+{
+    this->addViews(views, this->children.size());
+}
+
+void Box::addViews(const std::vector<View*>& views, size_t position)
+{
+    if (views.empty())
+        return;
+
+    this->children.reserve(this->children.size() + views.size());
+
+    for (size_t i = 0; i < views.size(); i++)
+        this->insertChild(views[i], position + i);
+
+    this->updateChildrenIndices(position + views.size());
+
+    // Layout and events, once for all of them
+    this->invalidate();
+
+    for (View* view : views)
+        view->willAppear();
+}
+
+size_t Box::getNodeIndex(size_t position)
+{
+    if (this->detachedChildren == 0)
+        return position;
+
+    // Detached views don't have their node in ours
+    size_t index = 0;
+    for (size_t i = 0; i < position; i++)
+    {
+        if (!this->children[i]->isDetached())
+            index++;
+    }
+
+    return index;
+}
+
+void Box::insertChild(View* view, size_t position)
 {
     // Add the view to our children and YGNode
+    if (view->isDetached())
+        this->detachedChildren++;
+    else
+        YGNodeInsertChild(this->ygNode, view->getYGNode(), this->getNodeIndex(position));
+
     this->children.insert(this->children.begin() + position, view);
 
-    if (!view->isDetached())
-        YGNodeInsertChild(this->ygNode, view->getYGNode(), position);
+    view->setParent(this, position);
 
-    // Allocate and set parent userdata
-    size_t* userdata = (size_t*)malloc(sizeof(size_t));
-    *userdata        = position;
+    // Move the IDs of the view tree to the index of our tree
+    Box* box = dynamic_cast<Box*>(view);
 
-    view->setParent(this, userdata);
+    if (box && box->viewIndex)
+    {
+        this->getTreeViewIndex(true)->merge(box->viewIndex.get());
+        box->viewIndex = nullptr;
+    }
+    else if (!box && view->getInternedId())
+    {
+        this->getTreeViewIndex(true)->add(view);
+    }
+}
 
-    // Layout and events
-    this->invalidate();
-    view->willAppear();
+void Box::updateChildrenIndices(size_t from)
+{
+    for (size_t i = from; i < this->children.size(); i++)
+        this->children[i]->setParent(this, i);
 }
 
-void Box::removeView(View* view)
+void Box::removeChildren(size_t start, size_t count, bool free)
 {
-    if (!view)
+    if (start >= this->children.size() || count == 0)
         return;
 
-    // Find the index of the view
-    size_t index;
-    bool found = false;
+    count    = std::min(count, this->children.size() - start);
+    auto end = this->children.begin() + start + count;
 
-    for (size_t i = 0; i < this->children.size(); i++)
+    // Remove the nodes: one by one for a single view, otherwise
+    // by putting back the ones to keep, to not search the nodes every time
+    if (count == 1)
     {
-        View* child = this->children[i];
+        if (!this->children[start]->isDetached())
+            YGNodeRemoveChild(this->ygNode, this->children[start]->getYGNode());
+    }
+    else
+    {
+        YGNodeRemoveAllChildren(this->ygNode);
 
-        if (child == view)
+        for (size_t i = 0; i < this->children.size(); i++)
         {
-            found = true;
-            index = i;
-            break;
+            View* child = this->children[i];
+
+            if ((i < start || i >= start + count) && !child->isDetached())
+                YGNodeInsertChild(this->ygNode, child->getYGNode(), YGNodeGetChildCount(this->ygNode));
         }
     }
 
-    if (!found)
-        return;
+    std::vector<View*> removed(this->children.begin() + start, end);
+    this->children.erase(this->children.begin() + start, end);
+
+    this->updateChildrenIndices(start);
+
+    ViewIndex* viewIndex = this->getTreeViewIndex(false);
+
+    for (View* view : removed)
+    {
+        if (view->isDetached())
+            this->detachedChildren--;
+
+        if (viewIndex)
+        {
+            // A detached Box becomes the root of its own tree, with its own index
+            Box* box                = dynamic_cast<Box*>(view);
+            ViewIndex* detachedRoot = !free && box ? box->getViewIndex(true) : nullptr;
 
-    // Remove it
-    YGNodeRemoveChild(this->ygNode, view->getYGNode());
-    this->children.erase(this->children.begin() + index);
+            removeFromViewIndex(viewIndex, view, detachedRoot);
+        }
 
-    view->willDisappear(true);
-    delete view;
+        view->willDisappear(true);
+        view->setParent(nullptr);
+
+        if (free)
+            delete view;
+    }
+
+    // The views can be in our spatial index or any above us
+    SpatialIndex::invalidateView(this);
 
     this->invalidate();
 }
 
+void Box::removeView(View* view)
+{
+    if (!view || view->getParent() != this)
+        return;
+
+    this->removeChildren(view->getIndexInParent(), 1, true);
+}
+
+void Box::removeViewsRange(size_t start, size_t count)
+{
+    this->removeChildren(start, count, true);
+}
+
+void Box::removeAllViews()
+{
+    this->removeChildren(0, this->children.size(), true);
+}
+
+bool Box::detachView(View* view)
+{
+    if (!view || view->getParent() != this)
+        return false;
+
+    this->removeChildren(view->getIndexInParent(), 1, false);
+    return true;
+}
+
 void Box::onFocusGained()
 {
     View::onFocusGained();
@@ -319,7 +467,8 @@ View* Box::getDefaultFocus()
 
 View* Box::getNextFocus(FocusDirection direction, View* currentView)
 {
-    void* parentUserData = currentView->getParentUserData();
+    if (this->spatialIndex)
+        return this->spatialIndex->getNextFocus(direction, currentView);
 
     // Return nullptr immediately if focus direction mismatches the box axis (clang-format refuses to split it in multiple lines...)
     if ((this->axis == Axis::ROW && direction != FocusDirection::LEFT && direction != FocusDirection::RIGHT) || (this->axis == Axis::COLUMN && direction != FocusDirection::UP && direction != FocusDirection::DOWN))
@@ -335,7 +484,7 @@ View* Box::getNextFocus(FocusDirection direction, View* currentView)
         offset = -1;
     }
 
-    size_t currentFocusIndex = *((size_t*)parentUserData) + offset;
+    size_t currentFocusIndex = currentView->getIndexInParent() + offset;
     View* currentFocus       = nullptr;
 
     while (!currentFocus && currentFocusIndex >= 0 && currentFocusIndex < this->children.size())
@@ -365,6 +514,19 @@ void Box::onWindowSizeChanged()
         child->onWindowSizeChanged();
 }
 
+void Box::setSpatialNavigationEnabled(bool enabled)
+{
+    if (enabled && !this->spatialIndex)
+        this->spatialIndex = std::make_unique<SpatialIndex>(this);
+    else if (!enabled)
+        this->spatialIndex = nullptr;
+}
+
+bool Box::isSpatialNavigationEnabled()
+{
+    return this->spatialIndex != nullptr;
+}
+
 std::vector<View*>& Box::getChildren()
 {
     return this->children;
@@ -372,6 +534,8 @@ std::vector<View*>& Box::getChildren()
 
 void Box::inflateFromXMLString(std::string xml)
 {
+    BRLS_TRACE_SCOPE("inflateXML");
+
     // Load XML
     tinyxml2::XMLDocument* document = new tinyxml2::XMLDocument();
     tinyxml2::XMLError error        = document->Parse(xml.c_str());
@@ -396,6 +560,8 @@ void Box::inflateFromXMLRes(std::string name)
 
 void Box::inflateFromXMLFile(std::string path)
 {
+    BRLS_TRACE_SCOPE("inflateXML");
+
     // Load XML
     tinyxml2::XMLDocument* document = new tinyxml2::XMLDocument();
     tinyxml2::XMLError error        = document->LoadFile(path.c_str());
@@ -517,20 +683,59 @@ void Box::setAlignItems(AlignItems alignment)
     this->invalidate();
 }
 
+static View* findViewInTree(View* view, const std::string* id)
+{
+    if (view->getInternedId() == id)
+        return view;
+
+    if (Box* box = dynamic_cast<Box*>(view))
+    {
+        for (View* child : box->getChildren())
+        {
+            View* result = findViewInTree(child, id);
+
+            if (result)
+                return result;
+        }
+    }
+
+    return nullptr;
+}
+
 View* Box::getView(std::string id)
 {
     if (id == this->id)
         return this;
 
-    for (View* child : this->children)
+    const std::string* interned = ViewIndex::getInterned(id);
+    ViewIndex* index            = this->getTreeViewIndex(false);
+
+    if (!interned || !index)
+        return nullptr;
+
+    View* result = nullptr;
+
+    for (View* view : index->find(interned))
     {
-        View* result = child->getView(id);
+        if (!view->isChildOf(this))
+            continue;
 
+        // Several matches: return the first one in the tree, as a tree walk would
         if (result)
-            return result;
+            return findViewInTree(this, interned);
+
+        result = view;
     }
 
-    return nullptr;
+    return result;
+}
+
+ViewIndex* Box::getViewIndex(bool create)
+{
+    if (!this->viewIndex && create)
+        this->viewIndex = std::make_unique<ViewIndex>();
+
+    return this->viewIndex.get();
 }
 
 bool Box::applyXMLAttribute(std::string name, std::string value)
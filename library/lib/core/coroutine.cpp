@@ -0,0 +1,119 @@
+/*
+    Copyright 2021 natinusala
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <algorithm>
+#include <borealis/core/coroutine.hpp>
+#include <borealis/core/logger.hpp>
+#include <exception>
+#include <functional>
+#include <stdexcept>
+
+namespace brls
+{
+
+void CoroutineScheduler::resumeNextFrame(CoroutineResumer resumer)
+{
+    CoroutineScheduler::frameResumers.push_back({ resumer, CoroutineScheduler::frame + 1 });
+}
+
+void CoroutineScheduler::resumeSoon(CoroutineResumer resumer)
+{
+    CoroutineScheduler::frameResumers.push_back({ resumer, CoroutineScheduler::frame });
+}
+
+void CoroutineScheduler::resumeAt(CoroutineResumer resumer, Time time)
+{
+    CoroutineScheduler::timedResumers.push_back({ resumer, time });
+    std::push_heap(CoroutineScheduler::timedResumers.begin(), CoroutineScheduler::timedResumers.end(), std::greater<TimedResumer>());
+}
+
+void CoroutineScheduler::update()
+{
+    // Gather everything that is due first, coroutines can suspend
+    // again while being resumed
+    std::vector<CoroutineResumer>& resuming = CoroutineScheduler::resuming;
+    std::vector<FrameResumer>& frameResumers = CoroutineScheduler::frameResumers;
+    std::vector<TimedResumer>& timedResumers = CoroutineScheduler::timedResumers;
+
+    size_t kept = 0;
+    for (size_t i = 0; i < frameResumers.size(); i++)
+    {
+        if (frameResumers[i].frame <= CoroutineScheduler::frame)
+            resuming.push_back(frameResumers[i].resumer);
+        else
+            frameResumers[kept++] = frameResumers[i];
+    }
+    frameResumers.resize(kept);
+
+    Time now = getCPUTimeUsec();
+    while (!timedResumers.empty() && timedResumers.front().time <= now)
+    {
+        std::pop_heap(timedResumers.begin(), timedResumers.end(), std::greater<TimedResumer>());
+        resuming.push_back(timedResumers.back().resumer);
+        timedResumers.pop_back();
+    }
+
+    // Resume them all, keeping the buffer around to avoid allocating every frame
+    for (size_t i = 0; i < resuming.size(); i++)
+        resuming[i].resume(resuming[i].address);
+
+    resuming.clear();
+
+    CoroutineScheduler::frame++;
+}
+
+void CoroutineWaitList::add(CoroutineResumer resumer)
+{
+    this->waiters.push_back(resumer);
+}
+
+void CoroutineWaitList::release()
+{
+    for (CoroutineResumer resumer : this->waiters)
+        CoroutineScheduler::resumeSoon(resumer);
+
+    this->waiters.clear();
+}
+
+bool CoroutineWaitList::empty()
+{
+    return this->waiters.empty();
+}
+
+#ifdef BRLS_COROUTINES
+
+void coroutineUnhandledException()
+{
+    try
+    {
+        std::rethrow_exception(std::current_exception());
+    }
+    catch (const std::exception& e)
+    {
+        Logger::error("Uncaught exception in coroutine: {}", e.what());
+    }
+    catch (...)
+    {
+        Logger::error("Uncaught exception in coroutine");
+    }
+
+    Logger::flush();
+    std::terminate();
+}
+
+#endif
+
+} // namespace brls
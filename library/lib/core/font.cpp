@@ -14,6 +14,8 @@
     limitations under the License.
 */
 
+#include <stdio.h>
+#include <stdlib.h>
 #include <unistd.h>
 
 #include <borealis/core/application.hpp>
@@ -25,8 +27,61 @@
 namespace brls
 {
 
+FontLoader::~FontLoader()
+{
+    for (auto& [path, font] : this->preloadedFonts)
+        free(font.data);
+}
+
+void FontLoader::preloadFontFile(std::string filePath)
+{
+    FILE* file = fopen(filePath.c_str(), "rb");
+
+    if (!file)
+        return;
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    unsigned char* data = size > 0 ? (unsigned char*)malloc(size) : nullptr;
+
+    if (!data || fread(data, 1, size, file) != (size_t)size)
+    {
+        Logger::warning("Could not read font file \"{}\" in advance", filePath);
+        free(data);
+        fclose(file);
+        return;
+    }
+
+    fclose(file);
+
+    this->preloadedFonts[filePath] = { data, (size_t)size };
+}
+
+void FontLoader::preloadMaterialFromResources()
+{
+    this->preloadFontFile(MATERIAL_ICONS_PATH);
+}
+
 bool FontLoader::loadFontFromFile(std::string fontName, std::string filePath)
 {
+    // Use the file read by preloadFonts() if there is one
+    auto preloaded = this->preloadedFonts.find(filePath);
+    if (preloaded != this->preloadedFonts.end())
+    {
+        PreloadedFont font = preloaded->second;
+        this->preloadedFonts.erase(preloaded);
+
+        // nanovg takes ownership of the data
+        bool loaded = Application::loadFontFromMemory(fontName, font.data, font.size, true);
+
+        if (!loaded)
+            Logger::error("{} font was located but couldn't be loaded", fontName);
+
+        return loaded;
+    }
+
     if (access(filePath.c_str(), F_OK) != -1)
     {
         bool loaded = Application::loadFontFromFile(fontName, filePath);
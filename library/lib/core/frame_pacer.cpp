@@ -0,0 +1,151 @@
+/*
+    Copyright 2021 natinusala
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <borealis/core/frame_pacer.hpp>
+#include <chrono>
+#include <thread>
+
+// OS sleeps are only precise to a few ms, so the limiter sleeps until
+// that much time before the deadline and spins for the rest
+#define FRAME_PACER_SPIN_THRESHOLD 2000 // µs
+
+// Maximum amount of time the fixed timestep accumulator can catch up in one frame,
+// to avoid spiraling down after a long stall (window minimized, breakpoint...)
+#define FRAME_PACER_MAX_ACCUMULATED 250.0f // ms
+
+#define FRAME_PACER_AVERAGE_FACTOR 0.05f
+
+namespace brls
+{
+
+void FramePacer::setTargetFramerate(unsigned fps)
+{
+    this->targetFramerate = fps;
+    this->targetFrameTime = fps == 0 ? 0 : 1000000 / fps;
+    this->frameDeadline   = 0;
+}
+
+unsigned FramePacer::getTargetFramerate()
+{
+    return this->targetFramerate;
+}
+
+void FramePacer::setFixedTimestep(float timestep)
+{
+    this->fixedTimestep = timestep > 0.0f ? timestep : 0.0f;
+    this->accumulator   = 0.0f;
+}
+
+float FramePacer::getFixedTimestep()
+{
+    return this->fixedTimestep;
+}
+
+void FramePacer::beginFrame()
+{
+    Time now = getCPUTimeUsec();
+
+    this->frameDelta = this->frameStart == 0 ? 0.0f : (float)(now - this->frameStart) / 1000.0f;
+    this->frameStart = now;
+
+    if (this->averageFrameTime == 0.0f)
+        this->averageFrameTime = this->frameDelta;
+    else
+        this->averageFrameTime += (this->frameDelta - this->averageFrameTime) * FRAME_PACER_AVERAGE_FACTOR;
+
+    if (this->fixedTimestep > 0.0f)
+    {
+        this->accumulator += this->frameDelta;
+
+        if (this->accumulator > FRAME_PACER_MAX_ACCUMULATED)
+            this->accumulator = FRAME_PACER_MAX_ACCUMULATED;
+    }
+}
+
+void FramePacer::endFrame()
+{
+    if (this->targetFrameTime == 0)
+        return;
+
+    Time now      = getCPUTimeUsec();
+    Time deadline = this->frameDeadline + this->targetFrameTime;
+
+    // Start over from now if we missed the deadline by more than a frame
+    // instead of rushing the next frames to catch up
+    if (this->frameDeadline == 0 || now - deadline > this->targetFrameTime)
+        deadline = now;
+
+    this->sleepUntil(deadline);
+    this->frameDeadline = deadline;
+}
+
+void FramePacer::sleepUntil(Time deadline)
+{
+    while (true)
+    {
+        Time remaining = deadline - getCPUTimeUsec();
+
+        if (remaining <= 0)
+            return;
+
+        if (remaining > FRAME_PACER_SPIN_THRESHOLD)
+            std::this_thread::sleep_for(std::chrono::microseconds(remaining - FRAME_PACER_SPIN_THRESHOLD));
+        else
+            std::this_thread::yield();
+    }
+}
+
+bool FramePacer::consumeFixedStep()
+{
+    if (this->fixedTimestep <= 0.0f || this->accumulator < this->fixedTimestep)
+        return false;
+
+    this->accumulator -= this->fixedTimestep;
+    return true;
+}
+
+float FramePacer::getFrameDelta()
+{
+    return this->frameDelta;
+}
+
+Time FramePacer::getFrameStartTime()
+{
+    return this->frameStart;
+}
+
+float FramePacer::getInterpolationAlpha()
+{
+    if (this->fixedTimestep <= 0.0f)
+        return 1.0f;
+
+    return this->accumulator / this->fixedTimestep;
+}
+
+float FramePacer::getAverageFrameTime()
+{
+    return this->averageFrameTime;
+}
+
+float FramePacer::getFramerate()
+{
+    if (this->averageFrameTime <= 0.0f)
+        return 0.0f;
+
+    return 1000.0f / this->averageFrameTime;
+}
+
+} // namespace brls
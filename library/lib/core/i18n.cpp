@@ -19,11 +19,21 @@
 
 #include <borealis/core/application.hpp>
 #include <borealis/core/assets.hpp>
+#include <borealis/core/binary_storage.hpp>
 #include <borealis/core/i18n.hpp>
 #include <filesystem>
 #include <algorithm>
+#include <cstring>
+#include <mutex>
 #include <unordered_map>
 
+// Compiled catalogs, see scripts/i18n-compile.py for the format
+#define CATALOG_MAGIC "BRLSI18N"
+#define CATALOG_VERSION 1
+#define CATALOG_HEADER_SIZE 24
+#define CATALOG_ENTRY_SIZE 24
+#define CATALOG_EXTENSION ".brlsi18n"
+
 namespace brls
 {
 
@@ -45,9 +55,6 @@ const std::string internalXML = R"xml(
        </brls:List>
     </brls:i18nDoc>)xml";
 
-static locales xmlDefaultLocale; // For default locale (en-US)
-static locales xmlCurrentLocale; // For current locale found by platform
-
 void getTextFromElements(tinyxml2::XMLElement* root, std::string existing_path, locales& target)
 {
     if (!root)
@@ -63,15 +70,15 @@ void getTextFromElements(tinyxml2::XMLElement* root, std::string existing_path,
             getTextFromElements(e2, path, target); // we use a recursive strategy to grab all elements.
         else if (std::strcmp(e2->Name(), "brls:String") == 0) // Otherwise, if the XML Element is a brls:String,
         {
-            tinyxml2::XMLText* textFromElem = e2->FirstChild()->ToText(); // we query the text,
-            target[path]                    = textFromElem->Value(); // and add a map element to the provided unordered map.
+            tinyxml2::XMLNode* textFromElem = e2->FirstChild(); // we query the text (empty strings have none),
+            target[path]                    = textFromElem && textFromElem->ToText() ? textFromElem->Value() : ""; // and add a map element to the provided unordered map.
         }
         else // Otherwise, if the element is unknown,
         {
             // we give an error message and continue looping
             Logger::warning("Found unknown element in i18n file. Element name is {}. Continuing...", e2->Name());
             continue;
-        } // TODO: Find out why invalid elements with text give a segementation fault
+        }
     }
 }
 
@@ -143,7 +150,218 @@ void i18nChecker()
     }
 }
 
-static void loadLocale(std::string locale, locales& target)
+static uint32_t load32(const uint8_t* data)
+{
+    return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+static uint64_t load64(const uint8_t* data)
+{
+    return (uint64_t)load32(data) | ((uint64_t)load32(data + 4) << 32);
+}
+
+static void store32(uint8_t* data, uint32_t value)
+{
+    data[0] = (uint8_t)value;
+    data[1] = (uint8_t)(value >> 8);
+    data[2] = (uint8_t)(value >> 16);
+    data[3] = (uint8_t)(value >> 24);
+}
+
+static void store64(uint8_t* data, uint64_t value)
+{
+    store32(data, (uint32_t)value);
+    store32(data + 4, (uint32_t)(value >> 32));
+}
+
+// Translations of one locale: a table of entries sorted by key hash followed by
+// the keys and values. Either mapped from a catalog compiled at build time,
+// or built in memory with the same layout when only the XML files are available.
+class I18nCatalog
+{
+  public:
+    bool open(const std::string& path)
+    {
+        this->clear();
+
+        if (!this->file.open(path))
+            return false;
+
+        if (!this->setData(this->file.getData(), this->file.getSize()))
+        {
+            Logger::error("Invalid i18n catalog {}, it must be compiled again", path);
+            this->clear();
+            return false;
+        }
+
+        return true;
+    }
+
+    void build(const locales& strings)
+    {
+        this->clear();
+
+        struct Entry
+        {
+            uint64_t hash;
+            const std::string* key;
+            const std::string* value;
+        };
+
+        std::vector<Entry> entries;
+        entries.reserve(strings.size());
+
+        size_t stringsSize = 0;
+        for (auto& [key, value] : strings)
+        {
+            entries.push_back({ I18nKey::hashName(key), &key, &value });
+            stringsSize += key.size() + value.size() + 2;
+        }
+
+        std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+            return a.hash != b.hash ? a.hash < b.hash : *a.key < *b.key;
+        });
+
+        size_t stringsOffset = CATALOG_HEADER_SIZE + entries.size() * CATALOG_ENTRY_SIZE;
+        this->buffer.resize(stringsOffset + stringsSize);
+
+        uint8_t* data = this->buffer.data();
+        memcpy(data, CATALOG_MAGIC, 8);
+        store32(data + 8, CATALOG_VERSION);
+        store32(data + 12, (uint32_t)entries.size());
+        store32(data + 16, (uint32_t)stringsOffset);
+        store32(data + 20, (uint32_t)stringsSize);
+
+        uint32_t offset = 0;
+        for (size_t i = 0; i < entries.size(); i++)
+        {
+            uint8_t* entry = data + CATALOG_HEADER_SIZE + i * CATALOG_ENTRY_SIZE;
+            store64(entry, entries[i].hash);
+
+            for (int j = 0; j < 2; j++)
+            {
+                const std::string* string = j == 0 ? entries[i].key : entries[i].value;
+
+                store32(entry + 8 + j * 8, offset);
+                store32(entry + 12 + j * 8, (uint32_t)string->size());
+
+                memcpy(data + stringsOffset + offset, string->c_str(), string->size() + 1);
+                offset += (uint32_t)string->size() + 1;
+            }
+        }
+
+        this->setData(data, this->buffer.size());
+    }
+
+    /**
+     * Looks for the given key, returns true and sets value if found.
+     * The value stays valid as long as the catalog is.
+     */
+    bool find(I18nKey key, std::string_view* value)
+    {
+        uint64_t hash = key.getHash();
+
+        // Binary search for the first entry with that hash
+        size_t low  = 0;
+        size_t high = this->count;
+        while (low < high)
+        {
+            size_t middle = low + (high - low) / 2;
+
+            if (load64(this->getEntry(middle)) < hash)
+                low = middle + 1;
+            else
+                high = middle;
+        }
+
+        for (size_t i = low; i < this->count; i++)
+        {
+            const uint8_t* entry = this->getEntry(i);
+
+            if (load64(entry) != hash)
+                break;
+
+            std::string_view entryKey;
+            if (this->getString(entry + 8, &entryKey) && entryKey == key.getName())
+                return this->getString(entry + 16, value);
+        }
+
+        return false;
+    }
+
+    void clear()
+    {
+        this->file.close();
+        this->buffer.clear();
+
+        this->entries     = nullptr;
+        this->count       = 0;
+        this->strings     = nullptr;
+        this->stringsSize = 0;
+    }
+
+  private:
+    MappedFile file;
+    std::vector<uint8_t> buffer; // when built from XML files
+
+    const uint8_t* entries = nullptr;
+    size_t count           = 0;
+    const char* strings    = nullptr;
+    size_t stringsSize     = 0;
+
+    bool setData(const uint8_t* data, size_t size)
+    {
+        if (size < CATALOG_HEADER_SIZE || memcmp(data, CATALOG_MAGIC, 8) != 0 || load32(data + 8) != CATALOG_VERSION)
+            return false;
+
+        size_t count         = load32(data + 12);
+        size_t stringsOffset = load32(data + 16);
+        size_t stringsSize   = load32(data + 20);
+
+        if (CATALOG_HEADER_SIZE + count * CATALOG_ENTRY_SIZE > stringsOffset || stringsOffset + stringsSize > size)
+            return false;
+
+        this->entries     = data + CATALOG_HEADER_SIZE;
+        this->count       = count;
+        this->strings     = (const char*)data + stringsOffset;
+        this->stringsSize = stringsSize;
+
+        return true;
+    }
+
+    const uint8_t* getEntry(size_t index)
+    {
+        return this->entries + index * CATALOG_ENTRY_SIZE;
+    }
+
+    bool getString(const uint8_t* reference, std::string_view* string)
+    {
+        size_t offset = load32(reference);
+        size_t length = load32(reference + 4);
+
+        if (offset + length >= this->stringsSize)
+            return false;
+
+        *string = std::string_view(this->strings + offset, length);
+        return true;
+    }
+};
+
+static I18nCatalog internalCatalog; // Built-in views texts
+static I18nCatalog defaultCatalog; // For default locale (en-US)
+static I18nCatalog currentCatalog; // For current locale found by platform
+
+// Parsed translations, by key hash, for the loaded locales
+static std::mutex formatsMutex;
+static std::unordered_map<uint64_t, internal::I18nFormat> formats;
+
+static void clearFormats()
+{
+    std::lock_guard<std::mutex> lock(formatsMutex);
+    formats.clear();
+}
+
+static void loadLocaleXML(std::string locale, I18nCatalog& target)
 {
     std::string localePath = BRLS_ASSET("i18n/" + locale);
 
@@ -158,6 +376,8 @@ static void loadLocale(std::string locale, locales& target)
         return;
     }
 
+    locales strings;
+
     // Iterate over all XML files in the directory
     for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(localePath))
     {
@@ -189,8 +409,30 @@ static void loadLocale(std::string locale, locales& target)
 
         // Iterate over all XML elements in the file
         std::string path_2 = entry.path().filename().stem().string();
-        getTextFromElements(root, path_2, target);
+        getTextFromElements(root, path_2, strings);
+    }
+
+    target.build(strings);
+}
+
+/**
+ * Loads the compiled catalog of the given locale if there is one,
+ * falls back to parsing the XML files otherwise.
+ * Returns true if the compiled catalog was used.
+ */
+static bool loadLocale(std::string locale, I18nCatalog& target)
+{
+    std::string catalogPath = BRLS_ASSET("i18n/" + locale + CATALOG_EXTENSION);
+
+    if (std::filesystem::exists(catalogPath) && target.open(catalogPath))
+    {
+        BRLS_LOG_DEBUG("Loaded compiled i18n catalog {}", catalogPath);
+        return true;
     }
+
+    BRLS_LOG_DEBUG("No compiled i18n catalog for locale {}, loading XML files", locale);
+    loadLocaleXML(locale, target);
+    return false;
 }
 
 void loadInternal()
@@ -209,7 +451,11 @@ void loadInternal()
     tinyxml2::XMLElement* root = doc.RootElement(); // We grab the root element (no need for the brls:i18nDoc check)
 
     // Iterate over all XML elements in the file
-    getTextFromElements(root, "brls", xmlDefaultLocale);
+    locales strings;
+    getTextFromElements(root, "brls", strings);
+    internalCatalog.build(strings);
+
+    clearFormats();
 }
 
 void loadTranslations()
@@ -218,57 +464,176 @@ void loadTranslations()
     loadInternal();
 
     // Then load text for default locale (en-US)
-    loadLocale(LOCALE_DEFAULT, xmlDefaultLocale);
+    // The i18n folder is checked at build time when the catalogs are compiled,
+    // only check it here if they are not
+    if (!loadLocale(LOCALE_DEFAULT, defaultCatalog))
+        i18nChecker();
 
     std::string currentLocaleName = Application::getLocale();
     // If current locale doesn't equal default locale (en-US), try loading current locale.
     // If the locale doesn't exist, it falls back to the default one.
     if (currentLocaleName != LOCALE_DEFAULT)
-        loadLocale(currentLocaleName, xmlCurrentLocale);
+        loadLocale(currentLocaleName, currentCatalog);
+    else
+        currentCatalog.clear();
+
+    clearFormats();
 }
 
-namespace internal
+// Splits the translation in text and arguments. Only handles automatic ({}) and manual ({0})
+// indexing without format specifications, other strings are left to fmt.
+static void parseFormat(std::string_view raw, internal::I18nFormat* format)
 {
-    std::string getRawStr(std::string stringName, bool internal)
+    format->raw            = raw;
+    format->simple         = true;
+    format->argumentsCount = 0;
+
+    std::string text;
+    int nextArgument = 0;
+    bool automatic   = false;
+    bool manual      = false;
+
+    for (size_t i = 0; i < raw.size(); i++)
     {
-        std::string currentLocaleName = Application::getLocale();
+        char c = raw[i];
 
-        // First look for translated string in current locale
-        if (currentLocaleName != LOCALE_DEFAULT)
+        if (c == '{' && i + 1 < raw.size() && raw[i + 1] == '{')
         {
-            for (auto& [path, value] : xmlCurrentLocale)
+            text += '{';
+            i++;
+        }
+        else if (c == '}' && i + 1 < raw.size() && raw[i + 1] == '}')
+        {
+            text += '}';
+            i++;
+        }
+        else if (c == '{')
+        {
+            size_t end = raw.find('}', i);
+            if (end == std::string_view::npos)
             {
-                if (stringName == path)
-                    return value;
+                format->simple = false;
+                return;
             }
-        }
 
-        // Then look for default locale or internal translation (is contained in default locale by default)
-        else if (currentLocaleName == LOCALE_DEFAULT || internal)
-        {
-            for (auto& [path, value] : xmlDefaultLocale)
+            std::string_view index = raw.substr(i + 1, end - i - 1);
+            int argument           = 0;
+
+            if (index.empty())
+            {
+                argument  = nextArgument++;
+                automatic = true;
+            }
+            else
             {
-                if (stringName == path)
-                    return value;
+                for (char digit : index)
+                {
+                    if (digit < '0' || digit > '9')
+                    {
+                        format->simple = false; // format specification or named argument
+                        return;
+                    }
+
+                    argument = argument * 10 + (digit - '0');
+                }
+
+                manual = true;
             }
+
+            // Mixing both is an error, let fmt report it
+            if (automatic && manual)
+            {
+                format->simple = false;
+                return;
+            }
+
+            if (!text.empty())
+                format->pieces.push_back({ std::move(text), -1 });
+
+            text.clear();
+            format->pieces.push_back({ "", argument });
+            format->argumentsCount = std::max(format->argumentsCount, (size_t)argument + 1);
+
+            i = end;
+        }
+        else if (c == '}')
+        {
+            format->simple = false; // unmatched, let fmt report it
+            return;
+        }
+        else
+        {
+            text += c;
         }
+    }
+
+    if (!text.empty())
+        format->pieces.push_back({ std::move(text), -1 });
+}
+
+namespace internal
+{
+    std::string_view findRawStr(I18nKey key)
+    {
+        std::string_view value;
+
+        // Translations are loaded in the background on startup
+        Application::waitForTranslations();
+
+        // Current locale first, then default locale, then internal translations
+        if (currentCatalog.find(key, &value) || defaultCatalog.find(key, &value) || internalCatalog.find(key, &value))
+            return value;
 
         // Fallback to returning the string name
-        return stringName;
+        return key.getName();
     }
-} // namespace internal
 
-inline namespace literals
-{
-    std::string operator"" _i18n(const char* str, size_t len)
+    std::string getRawStr(std::string stringName, bool internal)
     {
-        return internal::getRawStr(std::string(str, len));
+        return std::string(findRawStr(stringName));
+    }
+
+    const I18nFormat* getFormat(I18nKey key)
+    {
+        std::string_view raw = findRawStr(key);
+
+        // Strings without translation are not cached: the raw string
+        // is the key itself, which can be a temporary
+        if (raw.data() == key.getName().data())
+        {
+            static thread_local I18nFormat uncached;
+            uncached = I18nFormat();
+            parseFormat(raw, &uncached);
+            return &uncached;
+        }
+
+        std::lock_guard<std::mutex> lock(formatsMutex);
+
+        // Check that the cached format is the one of this translation, in case of hash collision
+        I18nFormat& format = formats[key.getHash()];
+        if (format.raw.data() != raw.data())
+        {
+            format = I18nFormat();
+            parseFormat(raw, &format);
+        }
+
+        return &format;
     }
 
-    std::string operator"" _internal(const char* str, size_t len)
+    std::string assembleFormat(const I18nFormat* format, const std::string* arguments)
     {
-        return internal::getRawStr(std::string(str, len), true);
+        size_t size = 0;
+        for (const I18nFormat::Piece& piece : format->pieces)
+            size += piece.argument < 0 ? piece.text.size() : arguments[piece.argument].size();
+
+        std::string result;
+        result.reserve(size);
+
+        for (const I18nFormat::Piece& piece : format->pieces)
+            result += piece.argument < 0 ? piece.text : arguments[piece.argument];
+
+        return result;
     }
-} // namespace literals
+} // namespace internal
 
 } // namespace brls
@@ -0,0 +1,331 @@
+/*
+    Copyright 2021 natinusala
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+#include <nanovg-gl/stb_image.h>
+#include <string.h>
+
+#include <algorithm>
+#include <borealis/core/image_atlas.hpp>
+#include <borealis/core/logger.hpp>
+
+namespace brls
+{
+
+// Every image is surrounded by a copy of its edges, so that
+// linear filtering never samples the neighbouring images
+static constexpr int PADDING = 1;
+
+NVGpaint AtlasImage::getPaint(NVGcontext* vg, float x, float y, float width, float height, float alpha) const
+{
+    float scaleX = width / this->width;
+    float scaleY = height / this->height;
+
+    return nvgImagePattern(
+        vg,
+        x - this->x * scaleX,
+        y - this->y * scaleY,
+        this->pageWidth * scaleX,
+        this->pageHeight * scaleY,
+        0.0f,
+        this->texture,
+        alpha);
+}
+
+static void copyPixels(unsigned char* dst, int dstStride, int dstX, int dstY, const unsigned char* src, int srcStride, int srcX, int srcY, int width, int height)
+{
+    for (int row = 0; row < height; row++)
+        memcpy(&dst[((dstY + row) * dstStride + dstX) * 4], &src[((srcY + row) * srcStride + srcX) * 4], width * 4);
+}
+
+// Copies the edges of the image in the padding around it
+static void extrude(unsigned char* pixels, int stride, int x, int y, int width, int height)
+{
+    for (int row = y; row < y + height; row++)
+    {
+        memcpy(&pixels[(row * stride + x - 1) * 4], &pixels[(row * stride + x) * 4], 4);
+        memcpy(&pixels[(row * stride + x + width) * 4], &pixels[(row * stride + x + width - 1) * 4], 4);
+    }
+
+    copyPixels(pixels, stride, x - 1, y - 1, pixels, stride, x - 1, y, width + 2, 1);
+    copyPixels(pixels, stride, x - 1, y + height, pixels, stride, x - 1, y + height - 1, width + 2, 1);
+}
+
+static void uploadPixels(NVGcontext* vg, int texture, int x, int y, int width, int height, const unsigned char* pixels)
+{
+    NVGparams* params = nvgInternalParams(vg);
+    params->renderUpdateTexture(params->userPtr, texture, x, y, width, height, pixels);
+}
+
+bool ImageAtlas::allocate(Page* page, int width, int height, int* x, int* y)
+{
+    // Lowest shelf the image fits in
+    Shelf* best = nullptr;
+    for (Shelf& shelf : page->shelves)
+    {
+        if (shelf.height >= height && page->width - shelf.width >= width && (!best || shelf.height < best->height))
+            best = &shelf;
+    }
+
+    // Open a new shelf rather than wasting more than a quarter of a taller one
+    bool wasteful = best && height * 4 < best->height * 3;
+
+    if ((!best || wasteful) && page->shelvesHeight + height <= page->height)
+    {
+        page->shelves.push_back({ page->shelvesHeight, height, 0 });
+        page->shelvesHeight += height;
+        best = &page->shelves.back();
+    }
+
+    if (!best)
+        return false;
+
+    *x = best->width;
+    *y = best->y;
+
+    best->width += width;
+
+    return true;
+}
+
+ImageAtlas::Page* ImageAtlas::createPage(NVGcontext* vg, std::string group, int flags)
+{
+    Page* page   = new Page();
+    page->group  = group;
+    page->flags  = flags;
+    page->width  = ImageAtlas::pageSize;
+    page->height = ImageAtlas::pageSize;
+    page->pixels.resize(page->width * page->height * 4, 0);
+
+    page->texture = nvgCreateImageRGBA(vg, page->width, page->height, flags, page->pixels.data());
+
+    if (page->texture == 0)
+    {
+        delete page;
+        return nullptr;
+    }
+
+    ImageAtlas::pages.push_back(page);
+
+    BRLS_LOG_DEBUG("Created atlas page {} for group \"{}\" ({} pages)", page->texture, group, ImageAtlas::pages.size());
+
+    return page;
+}
+
+bool ImageAtlas::repack(NVGcontext* vg, Page* page)
+{
+    // Keep the current layout to restore it if the images don't fit anymore
+    std::vector<Shelf> oldShelves = page->shelves;
+    int oldShelvesHeight          = page->shelvesHeight;
+
+    std::vector<std::pair<int, int>> oldPositions;
+    for (Entry* entry : page->entries)
+        oldPositions.push_back({ entry->x, entry->y });
+
+    page->shelves.clear();
+    page->shelvesHeight = 0;
+
+    // Tallest first makes for tighter shelves
+    std::vector<Entry*> sorted = page->entries;
+    std::stable_sort(sorted.begin(), sorted.end(), [](Entry* a, Entry* b) {
+        return a->height > b->height;
+    });
+
+    std::vector<unsigned char> pixels(page->pixels.size(), 0);
+
+    for (Entry* entry : sorted)
+    {
+        int x, y;
+        if (!ImageAtlas::allocate(page, entry->width + PADDING * 2, entry->height + PADDING * 2, &x, &y))
+        {
+            page->shelves       = oldShelves;
+            page->shelvesHeight = oldShelvesHeight;
+
+            for (size_t i = 0; i < page->entries.size(); i++)
+            {
+                page->entries[i]->x = oldPositions[i].first;
+                page->entries[i]->y = oldPositions[i].second;
+            }
+
+            return false;
+        }
+
+        copyPixels(pixels.data(), page->width, x, y, page->pixels.data(), page->width, entry->x - PADDING, entry->y - PADDING, entry->width + PADDING * 2, entry->height + PADDING * 2);
+
+        entry->x = x + PADDING;
+        entry->y = y + PADDING;
+    }
+
+    page->pixels    = std::move(pixels);
+    page->freedArea = 0;
+
+    nvgUpdateImage(vg, page->texture, page->pixels.data());
+
+    BRLS_LOG_DEBUG("Repacked atlas page {} ({} images)", page->texture, page->entries.size());
+
+    return true;
+}
+
+AtlasImage* ImageAtlas::load(NVGcontext* vg, std::string path, std::string group, int imageFlags)
+{
+    std::string key = group + "|" + std::to_string(imageFlags) + "|" + path;
+
+    auto it = ImageAtlas::entries.find(key);
+    if (it != ImageAtlas::entries.end())
+    {
+        it->second->references++;
+        return it->second;
+    }
+
+    // Check the size before decoding anything
+    int width, height, components;
+    if (!stbi_info(path.c_str(), &width, &height, &components))
+        return nullptr;
+
+    if (group.empty() && (ImageAtlas::sizeThreshold <= 0 || width > ImageAtlas::sizeThreshold || height > ImageAtlas::sizeThreshold))
+        return nullptr;
+
+    int paddedWidth  = width + PADDING * 2;
+    int paddedHeight = height + PADDING * 2;
+
+    if (paddedWidth > ImageAtlas::pageSize || paddedHeight > ImageAtlas::pageSize)
+        return nullptr;
+
+    // Same settings as nvgCreateImage()
+    stbi_set_unpremultiply_on_load(1);
+    stbi_convert_iphone_png_to_rgb(1);
+    unsigned char* pixels = stbi_load(path.c_str(), &width, &height, &components, 4);
+
+    if (!pixels)
+        return nullptr;
+
+    // Find room in a page of the group, repacking it if needed, or make a new one
+    Page* page = nullptr;
+    int x, y;
+
+    for (Page* candidate : ImageAtlas::pages)
+    {
+        if (candidate->group == group && candidate->flags == imageFlags && ImageAtlas::allocate(candidate, paddedWidth, paddedHeight, &x, &y))
+        {
+            page = candidate;
+            break;
+        }
+    }
+
+    if (!page)
+    {
+        for (Page* candidate : ImageAtlas::pages)
+        {
+            if (candidate->group != group || candidate->flags != imageFlags || candidate->freedArea < (size_t)(paddedWidth * paddedHeight))
+                continue;
+
+            if (ImageAtlas::repack(vg, candidate) && ImageAtlas::allocate(candidate, paddedWidth, paddedHeight, &x, &y))
+            {
+                page = candidate;
+                break;
+            }
+        }
+    }
+
+    if (!page)
+    {
+        page = ImageAtlas::createPage(vg, group, imageFlags);
+
+        if (!page || !ImageAtlas::allocate(page, paddedWidth, paddedHeight, &x, &y))
+        {
+            stbi_image_free(pixels);
+            return nullptr;
+        }
+    }
+
+    Entry* entry      = new Entry();
+    entry->texture    = page->texture;
+    entry->x          = x + PADDING;
+    entry->y          = y + PADDING;
+    entry->width      = width;
+    entry->height     = height;
+    entry->pageWidth  = page->width;
+    entry->pageHeight = page->height;
+    entry->key        = key;
+    entry->page       = page;
+    entry->references = 1;
+
+    copyPixels(page->pixels.data(), page->width, entry->x, entry->y, pixels, width, 0, 0, width, height);
+    extrude(page->pixels.data(), page->width, entry->x, entry->y, width, height);
+    uploadPixels(vg, page->texture, x, y, paddedWidth, paddedHeight, page->pixels.data());
+
+    stbi_image_free(pixels);
+
+    page->entries.push_back(entry);
+    ImageAtlas::entries[key] = entry;
+
+    return entry;
+}
+
+void ImageAtlas::release(NVGcontext* vg, AtlasImage* image)
+{
+    Entry* entry = static_cast<Entry*>(image);
+
+    if (--entry->references > 0)
+        return;
+
+    Page* page = entry->page;
+
+    page->entries.erase(std::find(page->entries.begin(), page->entries.end(), entry));
+    page->freedArea += (entry->width + PADDING * 2) * (entry->height + PADDING * 2);
+
+    ImageAtlas::entries.erase(entry->key);
+    delete entry;
+
+    if (page->entries.empty())
+    {
+        nvgDeleteImage(vg, page->texture);
+        ImageAtlas::pages.erase(std::find(ImageAtlas::pages.begin(), ImageAtlas::pages.end(), page));
+        delete page;
+    }
+}
+
+void ImageAtlas::setSizeThreshold(int size)
+{
+    ImageAtlas::sizeThreshold = size;
+}
+
+int ImageAtlas::getSizeThreshold()
+{
+    return ImageAtlas::sizeThreshold;
+}
+
+void ImageAtlas::setPageSize(int size)
+{
+    ImageAtlas::pageSize = size;
+}
+
+size_t ImageAtlas::getPageCount()
+{
+    return ImageAtlas::pages.size();
+}
+
+size_t ImageAtlas::getMemoryUsage()
+{
+    size_t size = 0;
+
+    for (Page* page : ImageAtlas::pages)
+        size += (size_t)page->width * page->height * 4 * 2;
+
+    return size;
+}
+
+} // namespace brls
@@ -0,0 +1,170 @@
+/*
+    Copyright 2021 natinusala
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <math.h>
+#include <nanovg-gl/stb_image.h>
+
+#include <algorithm>
+#include <borealis/core/image_decoder.hpp>
+
+namespace brls
+{
+
+// Source pixels covered by every destination pixel along one axis,
+// with a fixed number of weights per pixel (padded with zeros)
+struct BoxFilter
+{
+    std::vector<int> starts;
+    std::vector<float> weights;
+    int taps;
+};
+
+static BoxFilter makeBoxFilter(int srcSize, int dstSize)
+{
+    BoxFilter filter;
+
+    float ratio  = (float)srcSize / (float)dstSize;
+    filter.taps  = (int)ceilf(ratio) + 1;
+    filter.starts.resize(dstSize);
+    filter.weights.resize(dstSize * filter.taps, 0.0f);
+
+    for (int i = 0; i < dstSize; i++)
+    {
+        float begin = i * ratio;
+        float end   = std::min((i + 1) * ratio, (float)srcSize);
+        int first   = std::min((int)begin, srcSize - 1);
+
+        filter.starts[i] = std::min(first, srcSize - filter.taps < 0 ? 0 : srcSize - filter.taps);
+
+        for (int tap = 0; tap < filter.taps; tap++)
+        {
+            int source = filter.starts[i] + tap;
+            if (source >= srcSize)
+                break;
+
+            float coverage = std::min(end, (float)(source + 1)) - std::max(begin, (float)source);
+            if (coverage > 0.0f)
+                filter.weights[i * filter.taps + tap] = coverage / ratio;
+        }
+    }
+
+    return filter;
+}
+
+void ImageDecoder::downscale(const unsigned char* src, int srcWidth, int srcHeight, unsigned char* dst, int dstWidth, int dstHeight)
+{
+    BoxFilter columns = makeBoxFilter(srcWidth, dstWidth);
+    BoxFilter rows    = makeBoxFilter(srcHeight, dstHeight);
+
+    // Rows first, on whole rows at a time: the inner loops are plain
+    // multiply-adds over contiguous arrays that the compiler vectorizes
+    // (with room for the zero weighted taps past the end of tiny images)
+    std::vector<float> row((srcWidth + columns.taps) * 4);
+    int rowSize = srcWidth * 4;
+
+    for (int y = 0; y < dstHeight; y++)
+    {
+        std::fill(row.begin(), row.begin() + rowSize, 0.0f);
+
+        for (int tap = 0; tap < rows.taps; tap++)
+        {
+            float weight = rows.weights[y * rows.taps + tap];
+            if (weight == 0.0f)
+                continue;
+
+            const unsigned char* line = &src[(rows.starts[y] + tap) * rowSize];
+            for (int i = 0; i < rowSize; i++)
+                row[i] += line[i] * weight;
+        }
+
+        unsigned char* out = &dst[y * dstWidth * 4];
+        for (int x = 0; x < dstWidth; x++)
+        {
+            float pixel[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+            const float* weights = &columns.weights[x * columns.taps];
+            const float* in      = &row[columns.starts[x] * 4];
+
+            for (int tap = 0; tap < columns.taps; tap++)
+            {
+                for (int c = 0; c < 4; c++)
+                    pixel[c] += in[tap * 4 + c] * weights[tap];
+            }
+
+            for (int c = 0; c < 4; c++)
+                out[x * 4 + c] = (unsigned char)std::min(pixel[c] + 0.5f, 255.0f);
+        }
+    }
+}
+
+bool ImageDecoder::getSize(std::string path, int* width, int* height)
+{
+    int components;
+    return stbi_info(path.c_str(), width, height, &components) != 0;
+}
+
+bool ImageDecoder::decode(std::string path, int maxWidth, int maxHeight, DecodedImage* image)
+{
+    // Same settings as nvgCreateImage()
+    int width, height, components;
+    stbi_set_unpremultiply_on_load(1);
+    stbi_convert_iphone_png_to_rgb(1);
+    unsigned char* pixels = stbi_load(path.c_str(), &width, &height, &components, 4);
+
+    if (!pixels)
+        return false;
+
+    // Premultiply, so that transparent pixels don't bleed their color when averaged
+    size_t size = (size_t)width * height * 4;
+    for (size_t i = 0; i < size; i += 4)
+    {
+        unsigned alpha = pixels[i + 3];
+        pixels[i]      = (unsigned char)((pixels[i] * alpha + 127) / 255);
+        pixels[i + 1]  = (unsigned char)((pixels[i + 1] * alpha + 127) / 255);
+        pixels[i + 2]  = (unsigned char)((pixels[i + 2] * alpha + 127) / 255);
+    }
+
+    image->sourceWidth  = width;
+    image->sourceHeight = height;
+
+    // Fit in the maximum size
+    float scale = 1.0f;
+    if (maxWidth > 0 && width > maxWidth)
+        scale = std::min(scale, (float)maxWidth / (float)width);
+    if (maxHeight > 0 && height > maxHeight)
+        scale = std::min(scale, (float)maxHeight / (float)height);
+
+    if (scale < 1.0f)
+    {
+        image->width  = std::max(1, (int)roundf(width * scale));
+        image->height = std::max(1, (int)roundf(height * scale));
+        image->pixels.resize((size_t)image->width * image->height * 4);
+
+        ImageDecoder::downscale(pixels, width, height, image->pixels.data(), image->width, image->height);
+    }
+    else
+    {
+        image->width  = width;
+        image->height = height;
+        image->pixels.assign(pixels, pixels + size);
+    }
+
+    stbi_image_free(pixels);
+
+    return true;
+}
+
+} // namespace brls
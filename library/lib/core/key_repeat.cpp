@@ -0,0 +1,121 @@
+/*
+    Copyright 2021 natinusala
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <algorithm>
+#include <borealis/core/key_repeat.hpp>
+
+namespace brls
+{
+
+KeyRepeater::KeyRepeater()
+{
+    // Face and system buttons trigger actions that should not fire again on their own
+    for (enum ControllerButton button : { BUTTON_A, BUTTON_B, BUTTON_X, BUTTON_Y, BUTTON_BACK, BUTTON_START, BUTTON_GUIDE, BUTTON_LSB, BUTTON_RSB })
+        this->settings[button].enabled = false;
+
+    // Directions speed up when held, to go through long lists
+    for (enum ControllerButton button : { BUTTON_UP, BUTTON_RIGHT, BUTTON_DOWN, BUTTON_LEFT })
+    {
+        this->settings[button].minimumInterval  = 30.0f;
+        this->settings[button].accelerationTime = 1500.0f;
+    }
+}
+
+void KeyRepeater::setSettings(enum ControllerButton button, KeyRepeatSettings settings)
+{
+    this->settings[button] = settings;
+}
+
+KeyRepeatSettings KeyRepeater::getSettings(enum ControllerButton button)
+{
+    return this->settings[button];
+}
+
+void KeyRepeater::setMaximumCatchUp(unsigned repeats)
+{
+    this->maximumCatchUp = repeats;
+}
+
+float KeyRepeater::getInterval(const KeyRepeatSettings& settings, float repeatTime)
+{
+    if (settings.accelerationTime <= 0.0f || repeatTime >= settings.accelerationTime)
+        return settings.accelerationTime <= 0.0f ? settings.interval : settings.minimumInterval;
+
+    float progress = repeatTime / settings.accelerationTime;
+    return settings.interval + (settings.minimumInterval - settings.interval) * progress;
+}
+
+const std::vector<KeyPress>& KeyRepeater::update(const ControllerState& state)
+{
+    this->presses.clear();
+
+    // New presses
+    for (int i = 0; i < _BUTTON_MAX; i++)
+    {
+        if (state.buttons[i] && !this->pressed[i])
+        {
+            this->presses.push_back({ (enum ControllerButton)i, false, 1 });
+
+            // The last pressed button is the one repeating
+            this->repeatingButton = i;
+            this->pressTime       = state.timestamp;
+            this->nextRepeat      = this->settings[i].delay;
+            this->firstRepeat     = this->settings[i].delay;
+        }
+
+        this->pressed[i] = state.buttons[i];
+    }
+
+    if (this->repeatingButton < 0)
+        return this->presses;
+
+    // Stop repeating once released
+    if (!state.buttons[this->repeatingButton])
+    {
+        this->repeatingButton = -1;
+        return this->presses;
+    }
+
+    KeyRepeatSettings& settings = this->settings[this->repeatingButton];
+
+    if (!settings.enabled)
+        return this->presses;
+
+    // Count every repeat that should have happened since the last frame
+    float holdTime = (float)(state.timestamp - this->pressTime) / 1000.0f;
+    unsigned count = 0;
+
+    while (holdTime >= this->nextRepeat)
+    {
+        if (count < this->maximumCatchUp)
+            count++;
+
+        float repeatTime = this->nextRepeat - this->firstRepeat;
+        this->nextRepeat += std::max(this->getInterval(settings, repeatTime), 1.0f);
+    }
+
+    if (count == 0)
+        return this->presses;
+
+    if (settings.pageJumpDelay > 0.0f && holdTime - this->firstRepeat >= settings.pageJumpDelay)
+        count *= settings.pageJumpPresses;
+
+    this->presses.push_back({ (enum ControllerButton)this->repeatingButton, true, count });
+
+    return this->presses;
+}
+
+} // namespace brls
@@ -0,0 +1,238 @@
+/*
+    Copyright 2021 natinusala
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <borealis/core/latency.hpp>
+#include <borealis/core/logger.hpp>
+
+namespace brls
+{
+
+void LatencyHistogram::record(Time latency)
+{
+    if (latency < 0)
+        latency = 0;
+
+    Time bucket = latency / LatencyHistogram::BUCKET_WIDTH;
+    if (bucket > LatencyHistogram::BUCKETS)
+        bucket = LatencyHistogram::BUCKETS;
+
+    this->buckets[bucket]++;
+    this->count++;
+    this->total += latency;
+
+    if (latency > this->maximum)
+        this->maximum = latency;
+}
+
+void LatencyHistogram::reset()
+{
+    *this = LatencyHistogram();
+}
+
+unsigned LatencyHistogram::getCount()
+{
+    return this->count;
+}
+
+float LatencyHistogram::getPercentile(float percentile)
+{
+    if (this->count == 0)
+        return 0.0f;
+
+    unsigned target     = (unsigned)(percentile * (float)this->count);
+    unsigned cumulative = 0;
+
+    for (unsigned i = 0; i <= LatencyHistogram::BUCKETS; i++)
+    {
+        cumulative += this->buckets[i];
+
+        // Upper bound of the bucket, or the maximum if lower
+        if (cumulative > target || cumulative == this->count)
+            return (float)std::min((Time)(i + 1) * LatencyHistogram::BUCKET_WIDTH, this->maximum) / 1000.0f;
+    }
+
+    return this->getMaximum();
+}
+
+float LatencyHistogram::getAverage()
+{
+    if (this->count == 0)
+        return 0.0f;
+
+    return (float)this->total / (float)this->count / 1000.0f;
+}
+
+float LatencyHistogram::getMaximum()
+{
+    return (float)this->maximum / 1000.0f;
+}
+
+float LatencyTrace::getLatency(LatencyStage stage) const
+{
+    return (float)(this->timestamps[(int)stage] - this->timestamps[(int)LatencyStage::INPUT_SAMPLED]) / 1000.0f;
+}
+
+void LatencyTracer::setEnabled(bool enabled)
+{
+    LatencyTracer::enabled = enabled;
+
+    if (!enabled)
+        LatencyTracer::tracing = false;
+}
+
+bool LatencyTracer::isEnabled()
+{
+    return LatencyTracer::enabled;
+}
+
+void LatencyTracer::beginTrace(Time timestamp)
+{
+    if (!LatencyTracer::enabled || LatencyTracer::tracing)
+        return;
+
+    LatencyTracer::currentTrace                                              = LatencyTrace();
+    LatencyTracer::currentTrace.timestamps[(int)LatencyStage::INPUT_SAMPLED] = timestamp;
+
+    LatencyTracer::tracing = true;
+}
+
+void LatencyTracer::mark(LatencyStage stage)
+{
+    if (!LatencyTracer::tracing)
+        return;
+
+    LatencyTracer::currentTrace.timestamps[(int)stage] = getCPUTimeUsec();
+
+    if (stage == LatencyStage::SWAP_RETURNED)
+        LatencyTracer::finishTrace();
+}
+
+void LatencyTracer::finishTrace()
+{
+    LatencyTrace& trace = LatencyTracer::currentTrace;
+    Time sampled        = trace.timestamps[(int)LatencyStage::INPUT_SAMPLED];
+
+    // Stages that were not reached (like the layout when a frame is skipped)
+    // take the timestamp of the previous one
+    for (int i = 1; i < (int)LatencyStage::_LATENCY_STAGE_MAX; i++)
+    {
+        if (trace.timestamps[i] == 0)
+            trace.timestamps[i] = trace.timestamps[i - 1];
+
+        LatencyTracer::histograms[i].record(trace.timestamps[i] - sampled);
+    }
+
+    LatencyTracer::lastTrace = trace;
+    LatencyTracer::tracing   = false;
+
+    if (LatencyTracer::logInterval > 0)
+    {
+        Time now = trace.timestamps[(int)LatencyStage::SWAP_RETURNED];
+
+        if (LatencyTracer::lastLog == 0)
+            LatencyTracer::lastLog = now;
+        else if (now - LatencyTracer::lastLog >= LatencyTracer::logInterval * 1000)
+        {
+            LatencyTracer::log();
+            LatencyTracer::lastLog = now;
+        }
+    }
+}
+
+void LatencyTracer::log()
+{
+    LatencyHistogram* total = LatencyTracer::getHistogram(LatencyStage::SWAP_RETURNED);
+
+    Logger::info("Input latency over {} inputs: p50 {:.2f}ms, p95 {:.2f}ms, p99 {:.2f}ms, max {:.2f}ms (median to dispatch {:.2f}ms, layout {:.2f}ms, submit {:.2f}ms)",
+        total->getCount(),
+        total->getPercentile(0.50f),
+        total->getPercentile(0.95f),
+        total->getPercentile(0.99f),
+        total->getMaximum(),
+        LatencyTracer::getHistogram(LatencyStage::ACTION_DISPATCHED)->getPercentile(0.50f),
+        LatencyTracer::getHistogram(LatencyStage::LAYOUT_DONE)->getPercentile(0.50f),
+        LatencyTracer::getHistogram(LatencyStage::FRAME_SUBMITTED)->getPercentile(0.50f));
+}
+
+LatencyHistogram* LatencyTracer::getHistogram(LatencyStage stage)
+{
+    return &LatencyTracer::histograms[(int)stage];
+}
+
+const LatencyTrace& LatencyTracer::getLastTrace()
+{
+    return LatencyTracer::lastTrace;
+}
+
+void LatencyTracer::reset()
+{
+    for (LatencyHistogram& histogram : LatencyTracer::histograms)
+        histogram.reset();
+
+    LatencyTracer::lastTrace = LatencyTrace();
+}
+
+void LatencyTracer::setLogInterval(Time interval)
+{
+    LatencyTracer::logInterval = interval;
+    LatencyTracer::lastLog     = 0;
+}
+
+void LatencyTracer::setOverlayEnabled(bool enabled)
+{
+    LatencyTracer::overlayEnabled = enabled;
+}
+
+bool LatencyTracer::isOverlayEnabled()
+{
+    return LatencyTracer::overlayEnabled;
+}
+
+void LatencyTracer::drawOverlay(NVGcontext* vg, int font, float width)
+{
+    if (!LatencyTracer::overlayEnabled)
+        return;
+
+    LatencyHistogram* total = LatencyTracer::getHistogram(LatencyStage::SWAP_RETURNED);
+
+    std::string text = fmt::format("Input latency: {:.1f}ms (p50 {:.1f}ms, p95 {:.1f}ms)",
+        LatencyTracer::lastTrace.getLatency(LatencyStage::SWAP_RETURNED),
+        total->getPercentile(0.50f),
+        total->getPercentile(0.95f));
+
+    float fontSize = 16.0f;
+    float padding  = 6.0f;
+
+    nvgFontFaceId(vg, font);
+    nvgFontSize(vg, fontSize);
+    nvgTextAlign(vg, NVG_ALIGN_RIGHT | NVG_ALIGN_TOP);
+
+    float bounds[4];
+    nvgTextBounds(vg, width - padding, padding, text.c_str(), nullptr, bounds);
+
+    nvgBeginPath(vg);
+    nvgFillColor(vg, nvgRGBA(0, 0, 0, 160));
+    nvgRect(vg, bounds[0] - padding, bounds[1] - padding, bounds[2] - bounds[0] + padding * 2, bounds[3] - bounds[1] + padding * 2);
+    nvgFill(vg);
+
+    nvgFillColor(vg, nvgRGB(255, 255, 255));
+    nvgText(vg, width - padding, padding, text.c_str(), nullptr);
+}
+
+} // namespace brls
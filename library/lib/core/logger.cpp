@@ -17,15 +17,369 @@
 
 #include <fmt/core.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 #include <borealis/core/logger.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <thread>
+
+#define LOG_QUEUE_SIZE 1024 // must be a power of two
 
 namespace brls
 {
 
+static const char* LOG_PREFIXES[] = { "ERROR", "WARNING", "INFO", "DEBUG" };
+static const char* LOG_COLORS[]   = { "[0;31m", "[0;33m", "[0;34m", "[0;32m" };
+
+// Bounded lock-free queue of log lines (Vyukov's bounded queue), multiple producers
+// and one consumer: the logger thread
+class LogQueue
+{
+  public:
+    LogQueue()
+    {
+        for (size_t i = 0; i < LOG_QUEUE_SIZE; i++)
+            this->records[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    bool push(LogLevel level, std::string&& message)
+    {
+        Record* record;
+        size_t position = this->enqueuePosition.load(std::memory_order_relaxed);
+
+        while (true)
+        {
+            record          = &this->records[position & (LOG_QUEUE_SIZE - 1)];
+            size_t sequence = record->sequence.load(std::memory_order_acquire);
+            intptr_t diff   = (intptr_t)sequence - (intptr_t)position;
+
+            if (diff == 0)
+            {
+                if (this->enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                return false; // full
+            }
+            else
+            {
+                position = this->enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        record->level   = level;
+        record->message = std::move(message);
+        record->sequence.store(position + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    bool pop(LogLevel* level, std::string* message)
+    {
+        Record* record  = &this->records[this->dequeuePosition & (LOG_QUEUE_SIZE - 1)];
+        size_t sequence = record->sequence.load(std::memory_order_acquire);
+
+        if (sequence != this->dequeuePosition + 1)
+            return false; // empty
+
+        *level   = record->level;
+        *message = std::move(record->message);
+
+        record->sequence.store(this->dequeuePosition + LOG_QUEUE_SIZE, std::memory_order_release);
+        this->dequeuePosition++;
+
+        return true;
+    }
+
+  private:
+    struct Record
+    {
+        std::atomic<size_t> sequence;
+        LogLevel level;
+        std::string message;
+    };
+
+    Record records[LOG_QUEUE_SIZE];
+    std::atomic<size_t> enqueuePosition { 0 };
+    size_t dequeuePosition = 0;
+};
+
+// Logger thread and its sinks. Created on first log and never destroyed,
+// so that logging keeps working until the very end of the program.
+class LoggerBackend
+{
+  public:
+    LoggerBackend()
+    {
+        this->memorySink = std::make_shared<MemoryLogSink>();
+
+        this->sinks.push_back(std::make_shared<StdoutLogSink>());
+        this->sinks.push_back(this->memorySink);
+
+        std::thread thread(&LoggerBackend::run, this);
+        this->threadId = thread.get_id();
+        thread.detach();
+
+        atexit([] { Logger::flush(); });
+    }
+
+    void push(LogLevel level, std::string&& message)
+    {
+        // Never drop errors, wait for the logger thread to make room instead
+        while (!this->queue.push(level, std::move(message)))
+        {
+            if (level != LogLevel::ERROR)
+            {
+                this->dropped++;
+                return;
+            }
+
+            this->wakeCondition.notify_one();
+            std::this_thread::yield();
+        }
+
+        this->pushed++;
+        this->wakeCondition.notify_one();
+    }
+
+    void flush()
+    {
+        if (std::this_thread::get_id() == this->threadId)
+            return;
+
+        size_t target = this->pushed.load();
+
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->wakeCondition.notify_one();
+        this->flushCondition.wait(lock, [this, target] { return this->written >= target; });
+    }
+
+    void addSink(std::shared_ptr<LogSink> sink)
+    {
+        std::lock_guard<std::mutex> lock(this->sinksMutex);
+        this->sinks.push_back(sink);
+    }
+
+    MemoryLogSink* getMemorySink()
+    {
+        return this->memorySink.get();
+    }
+
+  private:
+    void run()
+    {
+        LogLevel level;
+        std::string message;
+
+        while (true)
+        {
+            size_t count = 0;
+
+            {
+                std::lock_guard<std::mutex> lock(this->sinksMutex);
+
+                while (this->queue.pop(&level, &message))
+                {
+                    for (std::shared_ptr<LogSink>& sink : this->sinks)
+                        sink->write(level, message);
+
+                    count++;
+                }
+
+                size_t dropped = this->dropped.exchange(0);
+                if (dropped > 0)
+                {
+                    message = fmt::format("{} log lines were dropped, the logger could not keep up", dropped);
+
+                    for (std::shared_ptr<LogSink>& sink : this->sinks)
+                        sink->write(LogLevel::WARNING, message);
+                }
+
+                if (count > 0 || dropped > 0)
+                {
+                    for (std::shared_ptr<LogSink>& sink : this->sinks)
+                        sink->flush();
+                }
+            }
+
+            std::unique_lock<std::mutex> lock(this->mutex);
+
+            this->written += count;
+            this->flushCondition.notify_all();
+
+            this->wakeCondition.wait_for(lock, std::chrono::milliseconds(100), [this] { return this->pushed.load() > this->written; });
+        }
+    }
+
+    LogQueue queue;
+
+    std::thread::id threadId;
+
+    std::mutex mutex;
+    std::condition_variable wakeCondition;
+    std::condition_variable flushCondition;
+
+    std::atomic<size_t> pushed { 0 };
+    std::atomic<size_t> dropped { 0 };
+    size_t written = 0; // protected by mutex
+
+    std::mutex sinksMutex;
+    std::vector<std::shared_ptr<LogSink>> sinks;
+    std::shared_ptr<MemoryLogSink> memorySink;
+};
+
+static LoggerBackend* getBackend()
+{
+    static LoggerBackend* backend = new LoggerBackend();
+    return backend;
+}
+
 void Logger::setLogLevel(LogLevel newLogLevel)
 {
     Logger::logLevel = newLogLevel;
 }
 
+void Logger::push(LogLevel level, std::string message)
+{
+    getBackend()->push(level, std::move(message));
+}
+
+void Logger::flush()
+{
+    getBackend()->flush();
+}
+
+void Logger::addSink(std::shared_ptr<LogSink> sink)
+{
+    getBackend()->addSink(sink);
+}
+
+MemoryLogSink* Logger::getMemorySink()
+{
+    return getBackend()->getMemorySink();
+}
+
+void StdoutLogSink::write(LogLevel level, const std::string& message)
+{
+    fmt::print("\033{}[{}]\033[0m {}\n", LOG_COLORS[(int)level], LOG_PREFIXES[(int)level], message);
+}
+
+void StdoutLogSink::flush()
+{
+    fflush(stdout);
+}
+
+RotatingFileLogSink::RotatingFileLogSink(std::string path, size_t maxSize, unsigned maxFiles)
+    : path(path)
+    , maxSize(maxSize)
+    , maxFiles(maxFiles)
+{
+    this->open();
+}
+
+RotatingFileLogSink::~RotatingFileLogSink()
+{
+    if (this->file)
+        fclose(this->file);
+}
+
+void RotatingFileLogSink::open()
+{
+    this->file = fopen(this->path.c_str(), "a");
+    this->size = 0;
+
+    if (!this->file)
+        return;
+
+    fseek(this->file, 0, SEEK_END);
+    long size = ftell(this->file);
+
+    if (size > 0)
+        this->size = (size_t)size;
+}
+
+void RotatingFileLogSink::rotate()
+{
+    if (this->file)
+        fclose(this->file);
+
+    // Shift every previous file by one, dropping the oldest
+    if (this->maxFiles > 1)
+    {
+        remove(fmt::format("{}.{}", this->path, this->maxFiles - 1).c_str());
+
+        for (int i = (int)this->maxFiles - 2; i >= 1; i--)
+            rename(fmt::format("{}.{}", this->path, i).c_str(), fmt::format("{}.{}", this->path, i + 1).c_str());
+
+        rename(this->path.c_str(), fmt::format("{}.1", this->path).c_str());
+    }
+    else
+    {
+        remove(this->path.c_str());
+    }
+
+    this->open();
+}
+
+void RotatingFileLogSink::write(LogLevel level, const std::string& message)
+{
+    if (this->size >= this->maxSize)
+        this->rotate();
+
+    if (!this->file)
+        return;
+
+    std::string line = fmt::format("[{}] {}\n", LOG_PREFIXES[(int)level], message);
+
+    fwrite(line.data(), 1, line.size(), this->file);
+    this->size += line.size();
+}
+
+void RotatingFileLogSink::flush()
+{
+    if (this->file)
+        fflush(this->file);
+}
+
+MemoryLogSink::MemoryLogSink(size_t capacity)
+    : capacity(capacity)
+{
+    this->lines.reserve(capacity);
+}
+
+void MemoryLogSink::write(LogLevel level, const std::string& message)
+{
+    if (this->capacity == 0)
+        return;
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    std::string line = fmt::format("[{}] {}", LOG_PREFIXES[(int)level], message);
+
+    if (this->lines.size() < this->capacity)
+        this->lines.push_back(std::move(line));
+    else
+        this->lines[this->next] = std::move(line);
+
+    this->next = (this->next + 1) % this->capacity;
+}
+
+std::vector<std::string> MemoryLogSink::getLines()
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    if (this->lines.size() < this->capacity)
+        return this->lines;
+
+    std::vector<std::string> lines;
+    lines.reserve(this->capacity);
+
+    for (size_t i = 0; i < this->capacity; i++)
+        lines.push_back(this->lines[(this->next + i) % this->capacity]);
+
+    return lines;
+}
+
 } // namespace brls
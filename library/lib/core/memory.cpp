@@ -0,0 +1,229 @@
+/*
+    Copyright 2021 natinusala
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+#include <fmt/core.h>
+#include <string.h>
+
+#include <algorithm>
+#include <borealis/core/application.hpp>
+#include <borealis/core/image_atlas.hpp>
+#include <borealis/core/logger.hpp>
+#include <borealis/core/memory.hpp>
+#include <borealis/core/shadow_cache.hpp>
+#include <borealis/core/view.hpp>
+#include <borealis/views/image.hpp>
+
+namespace brls
+{
+
+static std::string formatSize(size_t size)
+{
+    if (size >= 1024 * 1024)
+        return fmt::format("{:.1f} MB", (float)size / (1024.0f * 1024.0f));
+
+    return fmt::format("{:.1f} KB", (float)size / 1024.0f);
+}
+
+size_t MemoryReport::getTexturesSize() const
+{
+    return this->imageTexturesSize + this->atlasSize + this->shadowCacheSize + this->fontAtlasSize;
+}
+
+void MemoryTracker::viewCreated(View* view)
+{
+    view->previousLiveView = nullptr;
+    view->nextLiveView     = MemoryTracker::firstView;
+
+    if (MemoryTracker::firstView)
+        MemoryTracker::firstView->previousLiveView = view;
+
+    MemoryTracker::firstView = view;
+    MemoryTracker::viewsCount++;
+}
+
+void MemoryTracker::viewDeleted(View* view)
+{
+    if (view->previousLiveView)
+        view->previousLiveView->nextLiveView = view->nextLiveView;
+    else
+        MemoryTracker::firstView = view->nextLiveView;
+
+    if (view->nextLiveView)
+        view->nextLiveView->previousLiveView = view->previousLiveView;
+
+    view->previousLiveView = nullptr;
+    view->nextLiveView     = nullptr;
+
+    MemoryTracker::viewsCount--;
+}
+
+void MemoryTracker::yogaNodeCreated()
+{
+    MemoryTracker::yogaNodes++;
+}
+
+void MemoryTracker::yogaNodeFreed()
+{
+    MemoryTracker::yogaNodes--;
+}
+
+size_t MemoryTracker::getViewsCount()
+{
+    return MemoryTracker::viewsCount;
+}
+
+size_t MemoryTracker::getYogaNodesCount()
+{
+    return MemoryTracker::yogaNodes;
+}
+
+static size_t getXMLNodeSize(const tinyxml2::XMLNode* node)
+{
+    // Every node is counted as an element, the largest kind
+    size_t size = sizeof(tinyxml2::XMLElement);
+
+    if (node->Value())
+        size += strlen(node->Value()) + 1;
+
+    if (const tinyxml2::XMLElement* element = node->ToElement())
+    {
+        for (const tinyxml2::XMLAttribute* attribute = element->FirstAttribute(); attribute; attribute = attribute->Next())
+            size += sizeof(tinyxml2::XMLAttribute) + strlen(attribute->Name()) + strlen(attribute->Value()) + 2;
+    }
+
+    for (const tinyxml2::XMLNode* child = node->FirstChild(); child; child = child->NextSibling())
+        size += getXMLNodeSize(child);
+
+    return size;
+}
+
+size_t MemoryTracker::getXMLDocumentSize(tinyxml2::XMLDocument* document)
+{
+    return getXMLNodeSize(document);
+}
+
+MemoryReport MemoryTracker::getReport()
+{
+    MemoryReport report;
+    NVGcontext* vg = Application::getNVGContext();
+
+    report.views     = MemoryTracker::viewsCount;
+    report.yogaNodes = MemoryTracker::yogaNodes;
+
+    for (View* view = MemoryTracker::firstView; view; view = view->nextLiveView)
+    {
+        report.viewsByClass[view->getClassString()]++;
+
+        for (tinyxml2::XMLDocument* document : view->getBoundXMLDocuments())
+        {
+            report.xmlDocuments++;
+            report.xmlDocumentsSize += MemoryTracker::getXMLDocumentSize(document);
+        }
+
+        if (Image* image = dynamic_cast<Image*>(view))
+        {
+            size_t size = image->getTextureSize();
+
+            if (size > 0)
+            {
+                report.imageTextures++;
+                report.imageTexturesSize += size;
+            }
+        }
+    }
+
+    report.atlasSize       = ImageAtlas::getMemoryUsage();
+    report.shadowCacheSize = ShadowCache::getMemoryUsage();
+    report.fontAtlasSize   = vg ? (size_t)nvgFontAtlasMemory(vg) : 0;
+
+    report.themeEntries = Application::getTheme().getEntriesCount();
+    report.themeSize    = Application::getTheme().getMemoryUsage();
+
+    report.runningTickings = Ticking::runningTickings.size();
+
+    report.activities = Application::getActivitiesCount();
+    report.focusStack = Application::getFocusStackSize();
+
+    return report;
+}
+
+void MemoryTracker::log()
+{
+    MemoryReport report = MemoryTracker::getReport();
+
+    Logger::info("Memory: {} views, {} Yoga nodes, {} XML documents ({}), {} running tickings, {} activities, {} views in the focus stack",
+        report.views,
+        report.yogaNodes,
+        report.xmlDocuments,
+        formatSize(report.xmlDocumentsSize),
+        report.runningTickings,
+        report.activities,
+        report.focusStack);
+
+    Logger::info("Memory: textures {} (images {} in {} textures, atlas {}, shadows {}, fonts {}), theme {} ({} entries)",
+        formatSize(report.getTexturesSize()),
+        formatSize(report.imageTexturesSize),
+        report.imageTextures,
+        formatSize(report.atlasSize),
+        formatSize(report.shadowCacheSize),
+        formatSize(report.fontAtlasSize),
+        formatSize(report.themeSize),
+        report.themeEntries);
+
+    // Most common classes first
+    std::vector<std::pair<std::string, size_t>> classes(report.viewsByClass.begin(), report.viewsByClass.end());
+    std::stable_sort(classes.begin(), classes.end(), [](const auto& a, const auto& b) {
+        return a.second > b.second;
+    });
+
+    for (auto& viewClass : classes)
+        Logger::info("    {}: {}", viewClass.first, viewClass.second);
+}
+
+void MemoryTracker::setOverlayEnabled(bool enabled)
+{
+    MemoryTracker::overlayEnabled = enabled;
+    MemoryTracker::overlayTime    = 0;
+}
+
+bool MemoryTracker::isOverlayEnabled()
+{
+    return MemoryTracker::overlayEnabled;
+}
+
+const std::vector<std::string>& MemoryTracker::getOverlayLines()
+{
+    Time now = getCPUTimeUsec();
+
+    if (MemoryTracker::overlayTime != 0 && now - MemoryTracker::overlayTime < 1000000)
+        return MemoryTracker::overlayLines;
+
+    MemoryReport report = MemoryTracker::getReport();
+
+    MemoryTracker::overlayTime  = now;
+    MemoryTracker::overlayLines = {
+        fmt::format("Views: {} (Yoga nodes: {})", report.views, report.yogaNodes),
+        fmt::format("XML: {} documents ({})", report.xmlDocuments, formatSize(report.xmlDocumentsSize)),
+        fmt::format("Textures: {} (images {})", formatSize(report.getTexturesSize()), formatSize(report.imageTexturesSize)),
+        fmt::format("Atlas: {}, fonts: {}", formatSize(report.atlasSize), formatSize(report.fontAtlasSize)),
+        fmt::format("Tickings: {}, focus stack: {}", report.runningTickings, report.focusStack),
+    };
+
+    return MemoryTracker::overlayLines;
+}
+
+} // namespace brls
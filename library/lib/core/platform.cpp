@@ -16,6 +16,10 @@
 
 #include <borealis/core/platform.hpp>
 
+#ifdef __HEADLESS__
+#include <borealis/platforms/headless/headless_platform.hpp>
+#endif
+
 #ifdef __SWITCH__
 #include <borealis/platforms/switch/switch_platform.hpp>
 #endif
@@ -29,7 +33,9 @@ namespace brls
 
 Platform* Platform::createPlatform()
 {
-#if defined(__SWITCH__)
+#if defined(__HEADLESS__)
+    return new HeadlessPlatform();
+#elif defined(__SWITCH__)
     return new SwitchPlatform();
 #elif defined(__GLFW__)
     return new GLFWPlatform();
@@ -0,0 +1,251 @@
+/*
+    Copyright 2021 natinusala
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+#include <math.h>
+
+#include <algorithm>
+#include <borealis/core/shadow_cache.hpp>
+
+namespace brls
+{
+
+bool ShadowStyle::operator==(const ShadowStyle& other) const
+{
+    return this->cornerRadius == other.cornerRadius
+        && this->width == other.width
+        && this->feather == other.feather
+        && this->opacity == other.opacity
+        && this->offset == other.offset
+        && this->borderWidth == other.borderWidth
+        && (this->borderWidth == 0.0f
+            || (this->borderColor.r == other.borderColor.r
+                && this->borderColor.g == other.borderColor.g
+                && this->borderColor.b == other.borderColor.b
+                && this->borderColor.a == other.borderColor.a));
+}
+
+// Same as sdroundrect() in the nanovg shader, pt being relative to the center of the rectangle
+static float roundedRectDistance(float x, float y, float halfWidth, float halfHeight, float radius)
+{
+    float dx = fabsf(x) - (halfWidth - radius);
+    float dy = fabsf(y) - (halfHeight - radius);
+
+    return std::min(std::max(dx, dy), 0.0f) + hypotf(std::max(dx, 0.0f), std::max(dy, 0.0f)) - radius;
+}
+
+static float clamp01(float value)
+{
+    return std::min(std::max(value, 0.0f), 1.0f);
+}
+
+// Margin inside the rectangle where the shadow depends on both axes
+// and cannot be stretched
+static float getInsideMargin(const ShadowStyle& style)
+{
+    float margin = std::max({ style.cornerRadius * 2, std::max(1.0f, style.feather) / 2, style.borderWidth / 2 });
+    return margin + fabsf(style.width) + 1.0f;
+}
+
+void ShadowCache::render(NVGcontext* vg, Entry* entry)
+{
+    const ShadowStyle& style = entry->style;
+    float scale              = entry->scale;
+
+    float radius  = style.cornerRadius * 2;
+    float feather = std::max(1.0f, style.feather);
+    float border  = style.borderWidth / 2;
+
+    entry->inside        = (int)ceilf(getInsideMargin(style) * scale);
+    entry->outsideX      = (int)ceilf(std::max(style.offset, border + 1.0f) * scale);
+    entry->outsideTop    = entry->outsideX;
+    entry->outsideBottom = (int)ceilf(std::max(style.offset * 2, border + 1.0f) * scale);
+
+    // Smallest rectangle that can be sliced, with 3px to stretch between the corners
+    entry->width  = (entry->outsideX + entry->inside) * 2 + 3;
+    entry->height = entry->outsideTop + entry->inside * 2 + 3 + entry->outsideBottom;
+
+    float rectX    = entry->outsideX / scale;
+    float rectY    = entry->outsideTop / scale;
+    float rectSize = (entry->inside * 2 + 3) / scale;
+    float half     = rectSize / 2;
+
+    std::vector<unsigned char> pixels(entry->width * entry->height * 4);
+    unsigned char* pixel = pixels.data();
+
+    for (int py = 0; py < entry->height; py++)
+    {
+        for (int px = 0; px < entry->width; px++, pixel += 4)
+        {
+            // Relative to the rectangle
+            float x = (px + 0.5f) / scale - rectX;
+            float y = (py + 0.5f) / scale - rectY;
+
+            // Box gradient, clipped to the area around the rectangle
+            float shadow = 0.0f;
+            if (x >= -style.offset && x <= rectSize + style.offset && y >= -style.offset && y <= rectSize + style.offset * 2)
+            {
+                float distance = roundedRectDistance(x - half, y - style.width - half, half, half, radius);
+                shadow         = style.opacity * (1.0f - clamp01((distance + feather * 0.5f) / feather));
+            }
+
+            // Cut out the rectangle
+            float distance = roundedRectDistance(x - half, y - half, half, half, style.cornerRadius);
+            shadow *= clamp01(distance * scale + 0.5f);
+
+            // Border over it
+            float coverage = 0.0f;
+            if (style.borderWidth > 0.0f)
+                coverage = clamp01((border - fabsf(distance)) * scale + 0.5f) * style.borderColor.a;
+
+            // Premultiplied
+            float a  = clamp01(coverage + shadow * (1.0f - coverage));
+            pixel[0] = (unsigned char)roundf(style.borderColor.r * coverage * 255.0f);
+            pixel[1] = (unsigned char)roundf(style.borderColor.g * coverage * 255.0f);
+            pixel[2] = (unsigned char)roundf(style.borderColor.b * coverage * 255.0f);
+            pixel[3] = (unsigned char)roundf(a * 255.0f);
+        }
+    }
+
+    entry->image = nvgCreateImageRGBA(vg, entry->width, entry->height, NVG_IMAGE_PREMULTIPLIED, pixels.data());
+}
+
+ShadowCache::Entry* ShadowCache::getEntry(NVGcontext* vg, const ShadowStyle& style, float scale)
+{
+    useCounter++;
+
+    for (Entry& entry : ShadowCache::entries)
+    {
+        if (entry.scale == scale && entry.style == style)
+        {
+            entry.lastUse = useCounter;
+            return &entry;
+        }
+    }
+
+    // Make room by deleting the least recently used texture
+    if (ShadowCache::entries.size() >= ShadowCache::MAX_ENTRIES)
+    {
+        auto oldest = std::min_element(ShadowCache::entries.begin(), ShadowCache::entries.end(), [](const Entry& a, const Entry& b) {
+            return a.lastUse < b.lastUse;
+        });
+
+        nvgDeleteImage(vg, oldest->image);
+        ShadowCache::entries.erase(oldest);
+    }
+
+    Entry entry   = {};
+    entry.style   = style;
+    entry.scale   = scale;
+    entry.lastUse = useCounter;
+
+    ShadowCache::render(vg, &entry);
+
+    if (entry.image == 0)
+        return nullptr;
+
+    ShadowCache::entries.push_back(entry);
+    return &ShadowCache::entries.back();
+}
+
+bool ShadowCache::draw(NVGcontext* vg, const ShadowStyle& style, float x, float y, float width, float height, float alpha)
+{
+    // Render at the current scale, rounded up to a quarter to share textures
+    float xform[6];
+    nvgCurrentTransform(vg, xform);
+
+    float scale = ceilf(sqrtf(xform[0] * xform[0] + xform[1] * xform[1]) * 4.0f) / 4.0f;
+    scale       = std::max(scale, 0.25f);
+
+    // The corners must fit, with the rounding of the margins to whole pixels
+    float minimumSize = (getInsideMargin(style) + 1.0f / scale) * 2;
+    if (width < minimumSize || height < minimumSize)
+        return false;
+
+    Entry* entry = ShadowCache::getEntry(vg, style, scale);
+
+    if (!entry)
+        return false;
+
+    float inside        = entry->inside / scale;
+    float textureWidth  = entry->width / scale;
+    float textureHeight = entry->height / scale;
+
+    // Columns and rows of the nine-patch
+    float columns[4] = { x - entry->outsideX / scale, x + inside, x + width - inside, x + width + entry->outsideX / scale };
+    float rows[4]    = { y - entry->outsideTop / scale, y + inside, y + height - inside, y + height + entry->outsideBottom / scale };
+
+    // Where the texture goes for each of them: as is on the sides,
+    // with the middle texel stretched over the whole center
+    float stretchX = columns[2] - columns[1];
+    float stretchY = rows[2] - rows[1];
+
+    int middleX = entry->outsideX + entry->inside + 1;
+    int middleY = entry->outsideTop + entry->inside + 1;
+
+    float patternX[3]      = { columns[0], columns[1] - middleX * stretchX, columns[3] - textureWidth };
+    float patternY[3]      = { rows[0], rows[1] - middleY * stretchY, rows[3] - textureHeight };
+    float patternWidth[3]  = { textureWidth, entry->width * stretchX, textureWidth };
+    float patternHeight[3] = { textureHeight, entry->height * stretchY, textureHeight };
+
+    // Slices share their edges, antialiasing would show the seams
+    nvgSave(vg);
+    nvgShapeAntiAlias(vg, 0);
+
+    for (int row = 0; row < 3; row++)
+    {
+        for (int column = 0; column < 3; column++)
+        {
+            // The center is inside the rectangle, there is nothing to draw there
+            if (row == 1 && column == 1)
+                continue;
+
+            if ((row == 1 && stretchY <= 0.0f) || (column == 1 && stretchX <= 0.0f))
+                continue;
+
+            NVGpaint paint = nvgImagePattern(vg, patternX[column], patternY[row], patternWidth[column], patternHeight[row], 0.0f, entry->image, alpha);
+
+            nvgBeginPath(vg);
+            nvgRect(vg, columns[column], rows[row], columns[column + 1] - columns[column], rows[row + 1] - rows[row]);
+            nvgFillPaint(vg, paint);
+            nvgFill(vg);
+        }
+    }
+
+    nvgRestore(vg);
+
+    return true;
+}
+
+size_t ShadowCache::getMemoryUsage()
+{
+    size_t size = 0;
+
+    for (Entry& entry : ShadowCache::entries)
+        size += (size_t)entry.width * entry.height * 4;
+
+    return size;
+}
+
+void ShadowCache::clear(NVGcontext* vg)
+{
+    for (Entry& entry : ShadowCache::entries)
+        nvgDeleteImage(vg, entry.image);
+
+    ShadowCache::entries.clear();
+}
+
+} // namespace brls
@@ -0,0 +1,367 @@
+/*
+    Copyright 2021 natinusala
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <algorithm>
+#include <borealis/core/box.hpp>
+#include <borealis/core/spatial_index.hpp>
+#include <cmath>
+
+namespace brls
+{
+
+// Weight of the distance along the direction compared to the distance across it
+#define SPATIAL_MAJOR_WEIGHT 13.0f
+
+static int64_t getCellKey(int x, int y)
+{
+    return ((int64_t)x << 32) | (uint32_t)y;
+}
+
+// Projects the rect on the direction, so that going in the direction always means
+// going forward along [start, end], with [low, high] being the span across the direction
+static void project(float x, float y, float width, float height, FocusDirection direction, float* start, float* end, float* low, float* high)
+{
+    switch (direction)
+    {
+        case FocusDirection::RIGHT:
+            *start = x;
+            *end   = x + width;
+            break;
+        case FocusDirection::LEFT:
+            *start = -(x + width);
+            *end   = -x;
+            break;
+        case FocusDirection::DOWN:
+            *start = y;
+            *end   = y + height;
+            break;
+        case FocusDirection::UP:
+            *start = -(y + height);
+            *end   = -y;
+            break;
+    }
+
+    if (direction == FocusDirection::LEFT || direction == FocusDirection::RIGHT)
+    {
+        *low  = y;
+        *high = y + height;
+    }
+    else
+    {
+        *low  = x;
+        *high = x + width;
+    }
+}
+
+// Candidates outside of the "beam" of the current view (not overlapping it across
+// the direction) always lose against the ones inside
+struct SpatialScore
+{
+    bool outOfBeam;
+    float distance;
+
+    bool operator<(const SpatialScore& other) const
+    {
+        if (this->outOfBeam != other.outOfBeam)
+            return !this->outOfBeam;
+
+        return this->distance < other.distance;
+    }
+};
+
+SpatialIndex::SpatialIndex(Box* scope)
+    : scope(scope)
+{
+    SpatialIndex::indexes.push_back(this);
+}
+
+SpatialIndex::~SpatialIndex()
+{
+    std::vector<SpatialIndex*>& indexes = SpatialIndex::indexes;
+    indexes.erase(std::remove(indexes.begin(), indexes.end(), this), indexes.end());
+}
+
+void SpatialIndex::invalidateTree(View* root)
+{
+    for (SpatialIndex* index : SpatialIndex::indexes)
+    {
+        View* scope = index->scope;
+
+        if (scope == root || root->isChildOf(scope) || scope->isChildOf(root))
+            index->dirty = true;
+    }
+}
+
+void SpatialIndex::invalidateView(View* view)
+{
+    for (SpatialIndex* index : SpatialIndex::indexes)
+    {
+        if (index->scope == view || view->isChildOf(index->scope))
+            index->dirty = true;
+    }
+}
+
+SpatialIndex::Rect SpatialIndex::getRect(View* view)
+{
+    return {
+        view->getX() - this->scope->getX(),
+        view->getY() - this->scope->getY(),
+        view->getWidth(),
+        view->getHeight(),
+    };
+}
+
+void SpatialIndex::getCell(Rect rect, int* x, int* y)
+{
+    *x = (int)std::floor((rect.x + rect.width / 2) / this->cellSize);
+    *y = (int)std::floor((rect.y + rect.height / 2) / this->cellSize);
+}
+
+void SpatialIndex::collect(View* view)
+{
+    if (view->isFocusable())
+        this->collected.push_back({ view, this->getRect(view) });
+
+    if (Box* box = dynamic_cast<Box*>(view))
+    {
+        for (View* child : box->getChildren())
+            this->collect(child);
+    }
+}
+
+void SpatialIndex::insert(View* view, Rect rect)
+{
+    int x, y;
+    this->getCell(rect, &x, &y);
+
+    int64_t cell = getCellKey(x, y);
+    this->cells[cell].push_back(view);
+    this->entries[view] = { rect, cell, this->refreshes };
+}
+
+void SpatialIndex::removeFromCell(View* view, int64_t cell)
+{
+    auto it = this->cells.find(cell);
+    if (it == this->cells.end())
+        return;
+
+    std::vector<View*>& views = it->second;
+    views.erase(std::remove(views.begin(), views.end(), view), views.end());
+
+    if (views.empty())
+        this->cells.erase(it);
+}
+
+void SpatialIndex::refresh()
+{
+    if (!this->dirty)
+        return;
+
+    this->dirty = false;
+    this->refreshes++;
+
+    this->collected.clear();
+
+    for (View* child : this->scope->getChildren())
+        this->collect(child);
+
+    // Cells are about the size of a view, start over if the views got a lot bigger or smaller
+    float averageSize    = 0.0f;
+    this->maxHalfWidth  = 0.0f;
+    this->maxHalfHeight = 0.0f;
+
+    for (auto& [view, rect] : this->collected)
+    {
+        averageSize += std::max(rect.width, rect.height);
+        this->maxHalfWidth  = std::max(this->maxHalfWidth, rect.width / 2);
+        this->maxHalfHeight = std::max(this->maxHalfHeight, rect.height / 2);
+    }
+
+    if (!this->collected.empty())
+        averageSize = std::max(averageSize / this->collected.size(), 16.0f);
+
+    if (this->cellSize == 0.0f || averageSize > this->cellSize * 2 || averageSize < this->cellSize / 2)
+    {
+        this->cellSize = averageSize > 0.0f ? averageSize : 64.0f;
+        this->entries.clear();
+        this->cells.clear();
+    }
+
+    // Move the views that changed
+    this->minCellX = this->minCellY = INT32_MAX;
+    this->maxCellX = this->maxCellY = INT32_MIN;
+
+    for (auto& [view, rect] : this->collected)
+    {
+        int x, y;
+        this->getCell(rect, &x, &y);
+
+        this->minCellX = std::min(this->minCellX, x);
+        this->minCellY = std::min(this->minCellY, y);
+        this->maxCellX = std::max(this->maxCellX, x);
+        this->maxCellY = std::max(this->maxCellY, y);
+
+        auto it = this->entries.find(view);
+
+        if (it == this->entries.end())
+        {
+            this->insert(view, rect);
+            continue;
+        }
+
+        Entry& entry = it->second;
+        entry.rect   = rect;
+        entry.seen   = this->refreshes;
+
+        if (entry.cell != getCellKey(x, y))
+        {
+            this->removeFromCell(view, entry.cell);
+            this->insert(view, rect);
+        }
+    }
+
+    // Forget the views that are gone
+    for (auto it = this->entries.begin(); it != this->entries.end();)
+    {
+        if (it->second.seen != this->refreshes)
+        {
+            this->removeFromCell(it->first, it->second.cell);
+            it = this->entries.erase(it);
+        }
+        else
+        {
+            it++;
+        }
+    }
+}
+
+View* SpatialIndex::getNextFocus(FocusDirection direction, View* currentView)
+{
+    this->refresh();
+
+    if (this->entries.empty())
+        return nullptr;
+
+    Rect source = this->getRect(currentView);
+
+    float sourceStart, sourceEnd, sourceLow, sourceHigh;
+    project(source.x, source.y, source.width, source.height, direction, &sourceStart, &sourceEnd, &sourceLow, &sourceHigh);
+    float sourceCenter = (sourceLow + sourceHigh) / 2;
+
+    // Walk the grid forward, one row or column of cells at a time, starting from the one of
+    // the current view center (candidates centers are always further than ours)
+    bool horizontal = direction == FocusDirection::LEFT || direction == FocusDirection::RIGHT;
+    int step        = (direction == FocusDirection::RIGHT || direction == FocusDirection::DOWN) ? 1 : -1;
+
+    int sourceX, sourceY;
+    this->getCell(source, &sourceX, &sourceY);
+
+    int major    = horizontal ? sourceX : sourceY;
+    int majorMin = horizontal ? this->minCellX : this->minCellY;
+    int majorMax = horizontal ? this->maxCellX : this->maxCellY;
+    int minorMin = horizontal ? this->minCellY : this->minCellX;
+    int minorMax = horizontal ? this->maxCellY : this->maxCellX;
+
+    major = std::clamp(major, majorMin, majorMax);
+
+    View* best = nullptr;
+    SpatialScore bestScore;
+
+    for (; major >= majorMin && major <= majorMax; major += step)
+    {
+        for (int minor = minorMin; minor <= minorMax; minor++)
+        {
+            int x = horizontal ? major : minor;
+            int y = horizontal ? minor : major;
+
+            auto it = this->cells.find(getCellKey(x, y));
+            if (it == this->cells.end())
+                continue;
+
+            // Skip the cell if none of its views can beat the best one: they are centered
+            // in the cell, and reach at most the largest half size around their center
+            float cellStart, cellEnd, cellLow, cellHigh;
+            project(x * this->cellSize - this->maxHalfWidth, y * this->cellSize - this->maxHalfHeight, this->cellSize + this->maxHalfWidth * 2, this->cellSize + this->maxHalfHeight * 2, direction, &cellStart, &cellEnd, &cellLow, &cellHigh);
+
+            float centerStart, centerEnd, centerLow, centerHigh;
+            project(x * this->cellSize, y * this->cellSize, this->cellSize, this->cellSize, direction, &centerStart, &centerEnd, &centerLow, &centerHigh);
+
+            float majorBound = std::max(0.0f, cellStart - sourceEnd);
+            float minorBound = std::max({ 0.0f, centerLow - sourceCenter, sourceCenter - centerHigh });
+
+            SpatialScore bound = {
+                cellHigh <= sourceLow || cellLow >= sourceHigh,
+                SPATIAL_MAJOR_WEIGHT * majorBound * majorBound + minorBound * minorBound,
+            };
+
+            if (best && !(bound < bestScore))
+                continue;
+
+            for (View* view : it->second)
+            {
+                if (view == currentView || !view->isFocusable())
+                    continue;
+
+                Rect& rect = this->entries[view].rect;
+
+                float start, end, low, high;
+                project(rect.x, rect.y, rect.width, rect.height, direction, &start, &end, &low, &high);
+
+                // Must be further than the current view in the direction
+                if (start <= sourceStart || end <= sourceEnd)
+                    continue;
+
+                float majorDistance = std::max(0.0f, start - sourceEnd);
+                float minorDistance = (low + high) / 2 - sourceCenter;
+
+                SpatialScore score = {
+                    high <= sourceLow || low >= sourceHigh,
+                    SPATIAL_MAJOR_WEIGHT * majorDistance * majorDistance + minorDistance * minorDistance,
+                };
+
+                if (!best || score < bestScore)
+                {
+                    best      = view;
+                    bestScore = score;
+                }
+            }
+        }
+
+        // Stop once the next row or column is too far to contain anything better
+        if (best)
+        {
+            int next = major + step;
+            int x    = horizontal ? next : 0;
+            int y    = horizontal ? 0 : next;
+
+            float start, end, low, high;
+            project(x * this->cellSize - this->maxHalfWidth, y * this->cellSize - this->maxHalfHeight, this->cellSize + this->maxHalfWidth * 2, this->cellSize + this->maxHalfHeight * 2, direction, &start, &end, &low, &high);
+
+            float majorBound  = std::max(0.0f, start - sourceEnd);
+            SpatialScore bound = { false, SPATIAL_MAJOR_WEIGHT * majorBound * majorBound };
+
+            if (!(bound < bestScore))
+                break;
+        }
+    }
+
+    if (!best)
+        return nullptr;
+
+    return best->getDefaultFocus();
+}
+
+} // namespace brls
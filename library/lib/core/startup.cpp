@@ -0,0 +1,295 @@
+/*
+    Copyright 2021 natinusala
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+#include <borealis/core/async.hpp>
+#include <borealis/core/logger.hpp>
+#include <borealis/core/startup.hpp>
+#include <borealis/core/trace.hpp>
+
+namespace brls
+{
+
+const std::string& StartupStep::getName() const
+{
+    return this->name;
+}
+
+StartupThread StartupStep::getThread() const
+{
+    return this->thread;
+}
+
+bool StartupStep::isDone() const
+{
+    return this->state.load(std::memory_order_acquire) == DONE;
+}
+
+bool StartupStep::hasFailed() const
+{
+    return this->isDone() && this->exception != nullptr;
+}
+
+Time StartupStep::getStartTime() const
+{
+    return this->startTime;
+}
+
+Time StartupStep::getEndTime() const
+{
+    return this->endTime;
+}
+
+bool StartupStep::ranOnMainThread() const
+{
+    return this->onMainThread;
+}
+
+void StartupGraph::begin()
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    this->mainThread   = std::this_thread::get_id();
+    this->beginTime    = getCPUTimeUsec();
+    this->endTime      = 0;
+    this->mainWaitTime = 0;
+}
+
+StartupStep* StartupGraph::addStep(std::string name, StartupThread thread, std::vector<StartupStep*> dependencies, std::function<void()> run)
+{
+    StartupStep* step = new StartupStep();
+
+    step->name         = name;
+    step->thread       = thread;
+    step->dependencies = dependencies;
+    step->run          = run;
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->steps.emplace_back(step);
+    this->submitReadySteps();
+
+    return step;
+}
+
+bool StartupGraph::isReady(StartupStep* step)
+{
+    for (StartupStep* dependency : step->dependencies)
+    {
+        if (!dependency->isDone())
+            return false;
+    }
+
+    return true;
+}
+
+void StartupGraph::submitReadySteps()
+{
+    // Must be called with the mutex locked
+    for (std::unique_ptr<StartupStep>& step : this->steps)
+    {
+        if (step->thread != StartupThread::WORKER || step->submitted || !this->isReady(step.get()))
+            continue;
+
+        step->submitted = true;
+
+        StartupStep* pointer = step.get();
+        TaskPool::submit([this, pointer] { this->tryRun(pointer); });
+    }
+}
+
+bool StartupGraph::tryRun(StartupStep* step)
+{
+    // Whoever switches the step to RUNNING runs it, the others wait for it
+    int expected = StartupStep::PENDING;
+    if (!step->state.compare_exchange_strong(expected, StartupStep::RUNNING, std::memory_order_acq_rel))
+        return false;
+
+    step->onMainThread = std::this_thread::get_id() == this->mainThread;
+    step->startTime    = getCPUTimeUsec() - this->beginTime;
+
+    // Steps depending on a failed one fail with the same exception, without running
+    for (StartupStep* dependency : step->dependencies)
+    {
+        if (dependency->exception)
+        {
+            step->exception = dependency->exception;
+            break;
+        }
+    }
+
+    // Exceptions are kept for whoever waits for the step: the task pool
+    // would only log them and leave the step running forever
+    if (!step->exception)
+    {
+        BRLS_TRACE_SCOPE(step->name.c_str());
+
+        try
+        {
+            step->run();
+        }
+        catch (...)
+        {
+            step->exception = std::current_exception();
+        }
+    }
+
+    step->endTime = getCPUTimeUsec() - this->beginTime;
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    step->state.store(StartupStep::DONE, std::memory_order_release);
+    this->submitReadySteps();
+    this->condition.notify_all();
+
+    return true;
+}
+
+void StartupGraph::wait(StartupStep* step)
+{
+    if (!step)
+        return;
+
+    if (step->isDone())
+    {
+        if (step->exception)
+            std::rethrow_exception(step->exception);
+
+        return;
+    }
+
+    for (StartupStep* dependency : step->dependencies)
+        this->wait(dependency);
+
+    bool onMainThread = std::this_thread::get_id() == this->mainThread;
+
+    // Run the step here rather than waiting for a worker to get to it
+    if (step->thread == StartupThread::WORKER || onMainThread)
+        this->tryRun(step);
+
+    if (!step->isDone())
+    {
+        Time waitStart = getCPUTimeUsec();
+
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->condition.wait(lock, [step] { return step->isDone(); });
+
+        if (onMainThread)
+            this->mainWaitTime += getCPUTimeUsec() - waitStart;
+    }
+
+    if (step->exception)
+        std::rethrow_exception(step->exception);
+}
+
+void StartupGraph::finish()
+{
+    std::unique_lock<std::mutex> lock(this->mutex);
+
+    // Run main steps as soon as they are ready, help with the worker steps
+    // nobody picked up yet, and only block when everything left is running elsewhere
+    while (true)
+    {
+        StartupStep* next = nullptr;
+        bool remaining    = false;
+
+        for (std::unique_ptr<StartupStep>& step : this->steps)
+        {
+            if (step->isDone())
+                continue;
+
+            remaining = true;
+
+            if (step->state.load(std::memory_order_acquire) != StartupStep::PENDING || !this->isReady(step.get()))
+                continue;
+
+            if (!next || (step->thread == StartupThread::MAIN && next->thread != StartupThread::MAIN))
+                next = step.get();
+        }
+
+        if (!remaining)
+            break;
+
+        if (next)
+        {
+            lock.unlock();
+            this->tryRun(next);
+            lock.lock();
+            continue;
+        }
+
+        Time waitStart = getCPUTimeUsec();
+        this->condition.wait(lock);
+        this->mainWaitTime += getCPUTimeUsec() - waitStart;
+    }
+
+    this->endTime = getCPUTimeUsec() - this->beginTime;
+
+    std::exception_ptr exception = nullptr;
+    for (std::unique_ptr<StartupStep>& step : this->steps)
+    {
+        if (step->exception)
+        {
+            exception = step->exception;
+            break;
+        }
+    }
+
+    lock.unlock();
+    this->logReport();
+
+    if (exception)
+        std::rethrow_exception(exception);
+}
+
+void StartupGraph::logReport()
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    Time stepsTime = 0;
+
+    Logger::info("Startup report:");
+
+    for (std::unique_ptr<StartupStep>& step : this->steps)
+    {
+        if (!step->isDone())
+        {
+            Logger::info("  {}: not done", step->name);
+            continue;
+        }
+
+        if (step->exception)
+        {
+            Logger::info("  {}: failed", step->name);
+            continue;
+        }
+
+        Time duration = step->endTime - step->startTime;
+        stepsTime += duration;
+
+        Logger::info("  {}: {:.2f}ms on the {} thread (from {:.2f}ms to {:.2f}ms)",
+            step->name,
+            duration / 1000.0f,
+            step->onMainThread ? "main" : "worker",
+            step->startTime / 1000.0f,
+            step->endTime / 1000.0f);
+    }
+
+    Logger::info("Startup took {:.2f}ms for {:.2f}ms of steps, the main thread waited {:.2f}ms for workers",
+        this->endTime / 1000.0f,
+        stepsTime / 1000.0f,
+        this->mainWaitTime / 1000.0f);
+}
+
+} // namespace brls
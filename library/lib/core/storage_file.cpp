@@ -17,13 +17,20 @@
 #include <borealis/core/storage_file.hpp>
 #include <borealis/core/application.hpp>
 #include <borealis/core/assets.hpp>
+#include <borealis/core/async.hpp>
 
+#include <cstdio>
 #include <filesystem>
 #include <fstream>
 
 namespace brls
 {
 
+static bool endsWith(const std::string& string, const std::string& suffix)
+{
+    return string.size() >= suffix.size() && string.compare(string.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
 std::string IntStorageObject::getTypeName()
 {
     return "Int";
@@ -64,16 +71,16 @@ std::string StringListStorageObject::getTypeName()
     return "String";
 }
 
-bool StorageFile::init(std::string filename, std::string appname)
+bool StorageFile::init(std::string filename, std::string appname, StorageListBackend listBackend)
 {
     if (inited)
         return true;
 
     std::string folder;
-    if (brls::Application::getPlatform()->getName() == "GLFW")
-        folder = "./config/" + appname + "/";
-    else
+    if (brls::Application::getPlatform()->getName() == "Switch")
         folder = "/config/" + appname + "/";
+    else
+        folder = "./config/" + appname + "/";
 
     if (!std::filesystem::exists(folder))
         std::filesystem::create_directories(folder);
@@ -81,10 +88,19 @@ bool StorageFile::init(std::string filename, std::string appname)
     this->filename = filename + ".xml";
     config_path = folder + this->filename;
 
+    this->listBackend = listBackend;
+    if (listBackend == StorageListBackend::BINARY && !this->binaryLists.open(folder + filename + ".lists"))
+        return false;
+
+    this->writeBehindTimer.setEndCallback([this](bool finished) {
+        if (finished)
+            this->flushInBackground();
+    });
+
     if (std::filesystem::exists(config_path))
     {
-        inited = true;
-        return true;
+        inited = this->load();
+        return inited;
     }
 
     std::ofstream file;
@@ -94,7 +110,7 @@ bool StorageFile::init(std::string filename, std::string appname)
         file.close();
         inited = true;
 
-        Logger::debug("Successfully made file at {}!", config_path);
+        BRLS_LOG_DEBUG("Successfully made file at {}!", config_path);
         return true;
     }
 
@@ -103,4 +119,279 @@ bool StorageFile::init(std::string filename, std::string appname)
     return false;
 }
 
+StorageFile::~StorageFile()
+{
+    if (inited)
+        this->flush();
+}
+
+bool StorageFile::load()
+{
+    tinyxml2::XMLDocument doc;
+    tinyxml2::XMLError errorCode = doc.LoadFile(config_path.c_str());
+
+    // Blank file, not written to yet
+    if (errorCode == tinyxml2::XML_ERROR_EMPTY_DOCUMENT)
+        return true;
+
+    if (errorCode != tinyxml2::XML_SUCCESS)
+    {
+        Logger::error("TinyXML2 could not open the file. Error code {}.", std::to_string(errorCode));
+        Logger::error("More details: {}", doc.ErrorStr());
+        return false;
+    }
+
+    tinyxml2::XMLElement *root = doc.RootElement();
+    if (!root)
+        return true;
+
+    for (tinyxml2::XMLElement *e = root->FirstChildElement(); e != NULL; e = e->NextSiblingElement())
+    {
+        const char *name = e->Attribute("name");
+        if (!name)
+            continue;
+
+        std::string element = e->Name();
+
+        if (endsWith(element, "ListProperty"))
+        {
+            std::vector<std::string> values;
+
+            for (tinyxml2::XMLElement *v = e->FirstChildElement("brls:Value"); v != NULL; v = v->NextSiblingElement("brls:Value"))
+            {
+                const char *value = v->Attribute("value");
+                values.push_back(value ? value : "");
+            }
+
+            this->setListProperty(element, name, std::move(values));
+        }
+        else
+        {
+            const char *value = e->Attribute("value");
+            this->setProperty(element, name, value ? value : "");
+        }
+    }
+
+    // Loading is not a change
+    this->dirty = false;
+
+    return true;
+}
+
+StorageFile::Property* StorageFile::getProperty(const std::string& element, const std::string& name)
+{
+    auto it = this->properties.find(element + "/" + name);
+
+    if (it == this->properties.end())
+        return nullptr;
+
+    return &it->second;
+}
+
+void StorageFile::setProperty(const std::string& element, const std::string& name, std::string value)
+{
+    std::string key = element + "/" + name;
+    auto it         = this->properties.find(key);
+
+    if (it == this->properties.end())
+    {
+        this->order.push_back(key);
+        this->properties[key] = Property { element, name, std::move(value), {} };
+    }
+    else if (it->second.value != value)
+    {
+        it->second.value = std::move(value);
+    }
+    else
+    {
+        return; // unchanged, don't rewrite the file for nothing
+    }
+
+    this->onPropertyChanged();
+}
+
+void StorageFile::setListProperty(const std::string& element, const std::string& name, std::vector<std::string> values)
+{
+    std::string key = element + "/" + name;
+    auto it         = this->properties.find(key);
+
+    if (it == this->properties.end())
+    {
+        this->order.push_back(key);
+        this->properties[key] = Property { element, name, "", std::move(values) };
+    }
+    else if (it->second.values != values)
+    {
+        it->second.values = std::move(values);
+    }
+    else
+    {
+        return;
+    }
+
+    this->onPropertyChanged();
+}
+
+void StorageFile::onPropertyChanged()
+{
+    this->dirty = true;
+
+    if (!inited)
+        return;
+
+    if (this->writeBehindDelay == 0)
+        this->flush();
+    else if (!this->writeBehindTimer.isRunning())
+        this->writeBehindTimer.start(this->writeBehindDelay);
+}
+
+void StorageFile::setWriteBehindDelay(Time delay)
+{
+    this->writeBehindDelay = delay;
+
+    if (delay == 0 && this->dirty)
+        this->flush();
+}
+
+bool StorageFile::isDirty()
+{
+    return this->dirty;
+}
+
+std::string StorageFile::serialize()
+{
+    tinyxml2::XMLDocument doc;
+
+    tinyxml2::XMLNode *root = doc.NewElement("brls:StorageFile");
+    doc.InsertFirstChild(root);
+
+    for (const std::string& key : this->order)
+    {
+        Property& property = this->properties[key];
+
+        tinyxml2::XMLElement *element = doc.NewElement(property.element.c_str());
+        element->SetAttribute("name", property.name.c_str());
+
+        if (endsWith(property.element, "ListProperty"))
+        {
+            for (const std::string& value : property.values)
+            {
+                tinyxml2::XMLElement *e = doc.NewElement("brls:Value");
+                e->SetAttribute("value", value.c_str());
+                element->InsertEndChild(e);
+            }
+        }
+        else
+        {
+            element->SetAttribute("value", property.value.c_str());
+        }
+
+        root->InsertEndChild(element);
+    }
+
+    tinyxml2::XMLPrinter printer;
+    doc.Print(&printer);
+
+    return std::string(printer.CStr(), printer.CStrSize() - 1);
+}
+
+void StorageFile::prepareWrite()
+{
+    if (!this->dirty)
+        return;
+
+    std::string content = this->serialize();
+
+    std::lock_guard<std::mutex> lock(this->writeState->mutex);
+    this->writeState->content = std::move(content);
+    this->writeState->sequence++;
+
+    this->dirty = false;
+}
+
+bool StorageFile::flush()
+{
+    if (!inited)
+        return false;
+
+    this->writeBehindTimer.stop();
+    this->prepareWrite();
+
+    return StorageFile::writeFile(config_path, this->writeState.get());
+}
+
+void StorageFile::flushInBackground()
+{
+    this->prepareWrite();
+
+    std::shared_ptr<WriteState> state = this->writeState;
+    std::string path                  = config_path;
+
+    brls::async([state, path]() {
+        StorageFile::writeFile(path, state.get());
+    });
+}
+
+bool StorageFile::writeFile(std::string path, WriteState* state)
+{
+    // One write at a time, without blocking the main thread preparing the next one
+    std::lock_guard<std::mutex> fileLock(state->fileMutex);
+
+    std::string content;
+    uint64_t sequence;
+
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+
+        // Already written by a previous write
+        if (state->written >= state->sequence)
+            return true;
+
+        content  = state->content;
+        sequence = state->sequence;
+    }
+
+    // Write to a temporary file first to never leave a half written file behind
+    std::string tempPath = path + ".tmp";
+    FILE *file           = fopen(tempPath.c_str(), "wb");
+
+    if (!file)
+    {
+        Logger::error("StorageFile: Could not open {} for writing.", tempPath);
+        return false;
+    }
+
+    bool success = fwrite(content.data(), 1, content.size(), file) == content.size();
+    success      = fflush(file) == 0 && success;
+    fclose(file);
+
+    if (!success)
+    {
+        Logger::error("StorageFile: Could not write to {}.", tempPath);
+        std::remove(tempPath.c_str());
+        return false;
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, path, error);
+
+    // Some file systems cannot rename over an existing file
+    if (error)
+    {
+        std::filesystem::remove(path, error);
+        std::filesystem::rename(tempPath, path, error);
+    }
+
+    if (error)
+    {
+        Logger::error("StorageFile: Could not rename {} to {}: {}.", tempPath, path, error.message());
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(state->mutex);
+    state->written = sequence;
+
+    return true;
+}
+
 } // namespace brls
\ No newline at end of file
@@ -360,12 +360,31 @@ void Theme::getAllMetricKeys(const std::string prefix)
 {
     for (const auto &e : metrics)
     {
-        Logger::debug("Metric with name {}: {}", e.first, e.second);
+        BRLS_LOG_DEBUG("Metric with name {}: {}", e.first, e.second);
         if (startsWith(e.first, prefix))
         {
-            Logger::debug("Metric under {} prefix: {}", prefix, e.second);
+            BRLS_LOG_DEBUG("Metric under {} prefix: {}", prefix, e.second);
         }
     }
 }
 
+size_t Theme::getEntriesCount()
+{
+    return colors.size() + metrics.size();
+}
+
+size_t Theme::getMemoryUsage()
+{
+    // Keys, values and one node per entry, buckets
+    size_t size = (colors.bucket_count() + metrics.bucket_count()) * sizeof(void *);
+
+    for (const auto &e : colors)
+        size += sizeof(e) + sizeof(void *) + e.first.capacity();
+
+    for (const auto &e : metrics)
+        size += sizeof(e) + sizeof(void *) + e.first.capacity();
+
+    return size;
+}
+
 } // namespace brls
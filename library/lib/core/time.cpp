@@ -15,19 +15,14 @@
 */
 
 #include <borealis/core/time.hpp>
+#include <borealis/core/trace.hpp>
 
 namespace brls
 {
 
-void Ticking::updateTickings()
+void Ticking::updateTickings(float delta)
 {
-    // Update time
-    static Time previousTime = 0;
-
-    Time currentTime = getCPUTimeUsec() / 1000;
-    Time delta       = previousTime == 0 ? 0 : currentTime - previousTime;
-
-    previousTime = currentTime;
+    BRLS_TRACE_SCOPE("updateTickings");
 
     // Update every running ticking, kill them and execute cb if they are finished
     // We have to clone the running tickings list to avoid altering it while
@@ -45,6 +40,16 @@ void Ticking::updateTickings()
     }
 }
 
+float Ticking::getInterpolationAlpha()
+{
+    return Ticking::interpolationAlpha;
+}
+
+void Ticking::setInterpolationAlpha(float alpha)
+{
+    Ticking::interpolationAlpha = alpha;
+}
+
 void Ticking::start()
 {
     if (this->running)
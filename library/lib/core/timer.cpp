@@ -37,10 +37,10 @@ void Timer::setDuration(Time duration)
 
 void Timer::onStart()
 {
-    this->progress = 0;
+    this->progress = 0.0f;
 }
 
-bool Timer::onUpdate(Time delta)
+bool Timer::onUpdate(float delta)
 {
     this->progress += delta;
     return this->progress < this->duration;
@@ -48,13 +48,13 @@ bool Timer::onUpdate(Time delta)
 
 void Timer::onReset()
 {
-    this->progress = 0;
+    this->progress = 0.0f;
     this->duration = 0;
 }
 
 void Timer::onRewind()
 {
-    this->progress = 0;
+    this->progress = 0.0f;
 }
 
 void RepeatingTimer::start(Time period)
@@ -80,17 +80,21 @@ void RepeatingTimer::setCallback(TickingGenericCallback callback)
 
 void RepeatingTimer::onStart()
 {
-    this->progress = 0;
+    this->progress = 0.0f;
 }
 
-bool RepeatingTimer::onUpdate(Time delta)
+bool RepeatingTimer::onUpdate(float delta)
 {
     this->progress += delta;
 
     if (this->progress >= this->period)
     {
         this->callback();
-        this->progress = 0;
+
+        // Keep the remainder to avoid drifting
+        this->progress -= this->period;
+        if (this->progress >= this->period)
+            this->progress = 0.0f;
     }
 
     return true; // never stop
@@ -0,0 +1,172 @@
+/*
+    Copyright 2021 natinusala
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+#include <fmt/format.h>
+#include <stdio.h>
+
+#include <atomic>
+#include <borealis/core/logger.hpp>
+#include <borealis/core/trace.hpp>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace brls
+{
+
+// Ring buffer of the events of one thread. Only its thread writes in it,
+// the head is published after every event so that it can be exported from another thread.
+struct TraceBuffer
+{
+    std::unique_ptr<TraceEvent[]> events { new TraceEvent[Tracer::BUFFER_CAPACITY] };
+    std::atomic<size_t> head { 0 }; // total amount of events recorded
+    std::atomic<const char*> threadName { nullptr };
+    unsigned threadId;
+};
+
+// Buffers are never freed, even when their thread exits, to be able to export them later
+static std::mutex buffersMutex;
+static std::vector<std::unique_ptr<TraceBuffer>> buffers;
+
+static thread_local TraceBuffer* threadBuffer = nullptr;
+
+static TraceBuffer* getThreadBuffer()
+{
+    if (!threadBuffer)
+    {
+        std::lock_guard<std::mutex> lock(buffersMutex);
+
+        TraceBuffer* buffer = new TraceBuffer();
+        buffer->threadId    = buffers.size() + 1;
+        buffers.emplace_back(buffer);
+
+        threadBuffer = buffer;
+    }
+
+    return threadBuffer;
+}
+
+void Tracer::record(const char* name, Time start, Time duration)
+{
+    TraceBuffer* buffer = getThreadBuffer();
+    size_t head         = buffer->head.load(std::memory_order_relaxed);
+
+    buffer->events[head % BUFFER_CAPACITY] = { name, start, duration };
+    buffer->head.store(head + 1, std::memory_order_release);
+}
+
+void Tracer::setThreadName(const char* name)
+{
+    getThreadBuffer()->threadName.store(name, std::memory_order_release);
+}
+
+static void writeJSONString(std::string* out, const char* string)
+{
+    out->push_back('"');
+
+    for (const char* c = string; *c; c++)
+    {
+        if (*c == '"' || *c == '\\')
+            out->push_back('\\');
+
+        if ((unsigned char)*c < 0x20)
+            *out += fmt::format("\\u{:04x}", (unsigned char)*c);
+        else
+            out->push_back(*c);
+    }
+
+    out->push_back('"');
+}
+
+bool Tracer::exportJSON(const std::string& path)
+{
+    std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first       = true;
+    size_t count     = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(buffersMutex);
+
+        for (std::unique_ptr<TraceBuffer>& buffer : buffers)
+        {
+            const char* threadName = buffer->threadName.load(std::memory_order_acquire);
+
+            if (threadName)
+            {
+                json += first ? "" : ",";
+                json += fmt::format("{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":", buffer->threadId);
+                writeJSONString(&json, threadName);
+                json += "}}";
+                first = false;
+            }
+
+            size_t head  = buffer->head.load(std::memory_order_acquire);
+            size_t begin = head >= BUFFER_CAPACITY ? head - BUFFER_CAPACITY + 1 : 0;
+
+            for (size_t i = begin; i < head; i++)
+            {
+                TraceEvent event = buffer->events[i % BUFFER_CAPACITY];
+
+                // Skip the event if its thread wrapped around and started overwriting it while it was being copied
+                if (buffer->head.load(std::memory_order_acquire) - i >= BUFFER_CAPACITY)
+                    continue;
+
+                json += first ? "" : ",";
+                json += "{\"name\":";
+                writeJSONString(&json, event.name);
+                json += fmt::format(",\"cat\":\"brls\",\"ph\":\"X\",\"ts\":{},\"dur\":{},\"pid\":1,\"tid\":{}}}", event.start, event.duration, buffer->threadId);
+                first = false;
+                count++;
+            }
+        }
+    }
+
+    json += "]}\n";
+
+    FILE* file = fopen(path.c_str(), "wb");
+
+    if (!file)
+    {
+        Logger::error("Could not open trace file \"{}\"", path);
+        return false;
+    }
+
+    bool written = fwrite(json.data(), 1, json.size(), file) == json.size();
+    fclose(file);
+
+    if (!written)
+    {
+        Logger::error("Could not write trace file \"{}\"", path);
+        return false;
+    }
+
+    Logger::info("Exported {} trace events to \"{}\"", count, path);
+    return true;
+}
+
+void Tracer::setExportOnExit(const std::string& path)
+{
+    Tracer::exitPath = path;
+}
+
+void Tracer::exportOnExit()
+{
+    if (!Tracer::exitPath.empty())
+        Tracer::exportJSON(Tracer::exitPath);
+}
+
+} // namespace brls
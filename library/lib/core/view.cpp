@@ -20,10 +20,14 @@
 #include <algorithm>
 #include <borealis/core/animation.hpp>
 #include <borealis/core/application.hpp>
+#include <borealis/core/arena.hpp>
 #include <borealis/core/assets.hpp>
 #include <borealis/core/box.hpp>
 #include <borealis/core/i18n.hpp>
 #include <borealis/core/input.hpp>
+#include <borealis/core/memory.hpp>
+#include <borealis/core/shadow_cache.hpp>
+#include <borealis/core/trace.hpp>
 #include <borealis/core/util.hpp>
 #include <borealis/core/view.hpp>
 
@@ -45,9 +49,16 @@ static bool startsWith(const std::string& data, const std::string& prefix)
 View::View()
 {
     // Instantiate and prepare YGNode
-    this->ygNode = YGNodeNew();
+    if (Arena::getCurrent())
+        this->ygNode = YGNodeNewWithConfig(Arena::getYogaConfig());
+    else
+        this->ygNode = YGNodeNew();
+
     YGNodeSetContext(this->ygNode, this);
 
+    MemoryTracker::viewCreated(this);
+    MemoryTracker::yogaNodeCreated();
+
     YGNodeStyleSetWidthAuto(this->ygNode);
     YGNodeStyleSetHeightAuto(this->ygNode);
 
@@ -347,6 +358,16 @@ void View::drawShadow(NVGcontext* vg, FrameContext* ctx, Style style, float x, f
             break;
     }
 
+    ShadowStyle shadow;
+    shadow.cornerRadius = this->cornerRadius;
+    shadow.width        = shadowWidth;
+    shadow.feather      = shadowFeather;
+    shadow.opacity      = shadowOpacity / 255.0f;
+    shadow.offset       = shadowOffset;
+
+    if (ShadowCache::draw(vg, shadow, x, y, width, height, alpha * this->getAlpha()))
+        return;
+
     NVGpaint shadowPaint = nvgBoxGradient(
         vg,
         x, y + shadowWidth,
@@ -479,39 +500,51 @@ void View::drawHighlight(NVGcontext* vg, Theme theme, float alpha, Style style,
     }
     else
     {
-        float shadowOffset = style["brls/highlight/shadow_offset"];
+        // Shadow and border, cached
+        NVGcolor highlightColor1 = theme["brls/highlight/color1"];
 
-        // Shadow
-        NVGpaint shadowPaint = nvgBoxGradient(vg,
-            x, y + style["brls/highlight/shadow_width"],
-            width, height,
-            cornerRadius * 2, style["brls/highlight/shadow_feather"],
-            RGBA(0, 0, 0, style["brls/highlight/shadow_opacity"] * alpha), TRANSPARENT);
+        ShadowStyle shadow;
+        shadow.cornerRadius = cornerRadius;
+        shadow.width        = style["brls/highlight/shadow_width"];
+        shadow.feather      = style["brls/highlight/shadow_feather"];
+        shadow.opacity      = style["brls/highlight/shadow_opacity"] / 255.0f;
+        shadow.offset       = style["brls/highlight/shadow_offset"];
+        shadow.borderWidth  = strokeWidth;
+        shadow.borderColor  = nvgRGBAf(highlightColor1.r, highlightColor1.g, highlightColor1.b, 1.0f);
+
+        // The view alpha goes in the pattern, to not render a texture per frame while fading
+        if (!ShadowCache::draw(vg, shadow, x, y, width, height, alpha * this->getAlpha()))
+        {
+            // Shadow
+            NVGpaint shadowPaint = nvgBoxGradient(vg,
+                x, y + shadow.width,
+                width, height,
+                cornerRadius * 2, shadow.feather,
+                RGBAf(0, 0, 0, shadow.opacity * alpha), TRANSPARENT);
 
-        nvgBeginPath(vg);
-        nvgRect(vg, x - shadowOffset, y - shadowOffset,
-            width + shadowOffset * 2, height + shadowOffset * 3);
-        nvgRoundedRect(vg, x, y, width, height, cornerRadius);
-        nvgPathWinding(vg, NVG_HOLE);
-        nvgFillPaint(vg, shadowPaint);
-        nvgFill(vg);
+            nvgBeginPath(vg);
+            nvgRect(vg, x - shadow.offset, y - shadow.offset,
+                width + shadow.offset * 2, height + shadow.offset * 3);
+            nvgRoundedRect(vg, x, y, width, height, cornerRadius);
+            nvgPathWinding(vg, NVG_HOLE);
+            nvgFillPaint(vg, shadowPaint);
+            nvgFill(vg);
+
+            // Border
+            nvgBeginPath(vg);
+            nvgStrokeColor(vg, RGBAf(highlightColor1.r, highlightColor1.g, highlightColor1.b, alpha));
+            nvgStrokeWidth(vg, strokeWidth);
+            nvgRoundedRect(vg, x, y, width, height, cornerRadius);
+            nvgStroke(vg);
+        }
 
-        // Border
+        // Animated border
         float gradientX, gradientY, color;
         getHighlightAnimation(&gradientX, &gradientY, &color);
 
-        NVGcolor highlightColor1 = theme["brls/highlight/color1"];
-
-        NVGcolor pulsationColor = RGBAf((color * highlightColor1.r) + (1 - color) * highlightColor1.r,
-            (color * highlightColor1.g) + (1 - color) * highlightColor1.g,
-            (color * highlightColor1.b) + (1 - color) * highlightColor1.b,
-            alpha);
-
         NVGcolor borderColor = theme["brls/highlight/color2"];
         borderColor.a        = 0.5f * alpha * this->getAlpha();
 
-        float strokeWidth = style["brls/highlight/stroke_width"];
-
         NVGpaint border1Paint = nvgRadialGradient(vg,
             x + gradientX * width, y + gradientY * height,
             strokeWidth * 10, strokeWidth * 40,
@@ -522,12 +555,6 @@ void View::drawHighlight(NVGcontext* vg, Theme theme, float alpha, Style style,
             strokeWidth * 10, strokeWidth * 40,
             borderColor, TRANSPARENT);
 
-        nvgBeginPath(vg);
-        nvgStrokeColor(vg, pulsationColor);
-        nvgStrokeWidth(vg, strokeWidth);
-        nvgRoundedRect(vg, x, y, width, height, cornerRadius);
-        nvgStroke(vg);
-
         nvgBeginPath(vg);
         nvgStrokePaint(vg, border1Paint);
         nvgStrokeWidth(vg, strokeWidth);
@@ -651,15 +678,15 @@ void View::setActionAvailable(enum ControllerButton button, bool available)
         it->available = available;
 }
 
-void View::setParent(Box* parent, void* parentUserdata)
+void View::setParent(Box* parent, size_t index)
 {
-    this->parent         = parent;
-    this->parentUserdata = parentUserdata;
+    this->parent      = parent;
+    this->parentIndex = index;
 }
 
-void* View::getParentUserData()
+size_t View::getIndexInParent()
 {
-    return this->parentUserdata;
+    return this->parentIndex;
 }
 
 bool View::isFocused()
@@ -995,9 +1022,15 @@ void View::invalidate()
         YGNodeMarkDirty(this->ygNode);
 
     if (this->hasParent() && !this->detached)
+    {
         this->getParent()->invalidate();
+    }
     else
+    {
+        BRLS_TRACE_SCOPE("layout");
         YGNodeCalculateLayout(this->ygNode, YGUndefined, YGUndefined, YGDirectionLTR);
+        SpatialIndex::invalidateTree(this);
+    }
 }
 
 float View::getX()
@@ -1105,7 +1138,7 @@ void View::show(std::function<void(void)> cb, bool animate, float animationDurat
         return;
     }
 
-    brls::Logger::debug("Showing {}", this->describe());
+    BRLS_LOG_DEBUG("Showing {}", this->describe());
 
     this->hidden = false;
 
@@ -1147,7 +1180,7 @@ void View::hide(std::function<void(void)> cb, bool animated, float animationDura
         return;
     }
 
-    brls::Logger::debug("Hiding {}", this->describe());
+    BRLS_LOG_DEBUG("Hiding {}", this->describe());
 
     this->hidden = true;
     this->fadeIn = false;
@@ -1233,23 +1266,42 @@ std::string View::getCustomNavigationRouteId(FocusDirection direction)
     return this->customFocusById[direction];
 }
 
+void* View::operator new(size_t size)
+{
+    void* memory = Arena::allocate(size);
+
+    if (!memory)
+        throw std::bad_alloc();
+
+    return memory;
+}
+
+void View::operator delete(void* memory)
+{
+    Arena::deallocate(memory);
+}
+
 View::~View()
 {
     this->resetClickAnimation();
 
-    // Parent userdata
-    if (this->parentUserdata)
-    {
-        free(this->parentUserdata);
-        this->parentUserdata = nullptr;
-    }
-
     // Focus sanity check
     if (Application::getCurrentFocus() == this)
         Application::giveFocus(nullptr);
 
     for (tinyxml2::XMLDocument* document : this->boundDocuments)
         delete document;
+
+    // Detaches it from the parent node, if any
+    YGNodeFree(this->ygNode);
+
+    MemoryTracker::yogaNodeFreed();
+    MemoryTracker::viewDeleted(this);
+}
+
+CancellationToken View::getLifetimeToken()
+{
+    return this->lifetime.getToken();
 }
 
 std::string View::getStringXMLAttributeValue(std::string value)
@@ -1522,6 +1574,8 @@ View* View::createFromXMLResource(std::string name)
 
 View* View::createFromXMLString(std::string xml)
 {
+    BRLS_TRACE_SCOPE("inflateXML");
+
     tinyxml2::XMLDocument* document = new tinyxml2::XMLDocument();
     tinyxml2::XMLError error        = document->Parse(xml.c_str());
 
@@ -1540,6 +1594,8 @@ View* View::createFromXMLString(std::string xml)
 
 View* View::createFromXMLFile(std::string path)
 {
+    BRLS_TRACE_SCOPE("inflateXML");
+
     tinyxml2::XMLDocument* document = new tinyxml2::XMLDocument();
     tinyxml2::XMLError error        = document->LoadFile(path.c_str());
 
@@ -1911,6 +1967,7 @@ void View::setVisibility(Visibility visibility)
     }
 
     this->visibility = visibility;
+    SpatialIndex::invalidateView(this);
 
     if (visibility == Visibility::VISIBLE)
         this->willAppear();
@@ -1983,15 +2040,37 @@ View* View::getView(std::string id)
 
 View* View::getNearestView(std::string id)
 {
-    // First try a children of ours
-    View* child = this->getView(id);
+    const std::string* interned = ViewIndex::getInterned(id);
+    ViewIndex* index            = this->getTreeViewIndex(false);
 
-    if (child)
-        return child;
+    if (!interned || !index)
+        return this->getView(id);
 
-    // Then go up one level and try again
-    if (this->hasParent())
-        return this->getParent()->getNearestView(id);
+    const std::vector<View*>& views = index->find(interned);
+
+    if (views.empty())
+        return nullptr;
+
+    // Start with ourself and our children, then go up one level and try again
+    for (View* scope = this; scope; scope = scope->getParent())
+    {
+        View* result = nullptr;
+
+        for (View* view : views)
+        {
+            if (view != scope && !view->isChildOf(scope))
+                continue;
+
+            // Several matches in that scope: let getView() pick the first one in the tree
+            if (result)
+                return scope->getView(id);
+
+            result = view;
+        }
+
+        if (result)
+            return result;
+    }
 
     return nullptr;
 }
@@ -2001,7 +2080,42 @@ void View::setId(std::string id)
     if (id == "")
         fatal("ID cannot be empty");
 
-    this->id = id;
+    ViewIndex* index = this->getTreeViewIndex(true);
+
+    if (index && this->internedId)
+        index->remove(this);
+
+    this->id         = id;
+    this->internedId = ViewIndex::intern(id);
+
+    if (index)
+        index->add(this);
+}
+
+const std::string* View::getInternedId()
+{
+    return this->internedId;
+}
+
+bool View::isChildOf(View* ancestor)
+{
+    for (View* parent = this->getParent(); parent; parent = parent->getParent())
+    {
+        if (parent == ancestor)
+            return true;
+    }
+
+    return false;
+}
+
+ViewIndex* View::getTreeViewIndex(bool create)
+{
+    View* root = this;
+
+    while (root->hasParent())
+        root = root->getParent();
+
+    return root->getViewIndex(create);
 }
 
 bool View::isFocusable()
@@ -2022,6 +2136,11 @@ void View::bindXMLDocument(tinyxml2::XMLDocument* document)
     this->boundDocuments.push_back(document);
 }
 
+const std::vector<tinyxml2::XMLDocument*>& View::getBoundXMLDocuments()
+{
+    return this->boundDocuments;
+}
+
 void View::setWireframeEnabled(bool wireframe)
 {
     this->wireframeEnabled = wireframe;
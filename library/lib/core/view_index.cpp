@@ -0,0 +1,81 @@
+/*
+    Copyright 2021 natinusala
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <algorithm>
+#include <borealis/core/view.hpp>
+#include <borealis/core/view_index.hpp>
+
+namespace brls
+{
+
+const std::string* ViewIndex::intern(const std::string& id)
+{
+    std::lock_guard<std::mutex> lock(ViewIndex::idsMutex);
+    return &*ViewIndex::ids.insert(id).first;
+}
+
+const std::string* ViewIndex::getInterned(const std::string& id)
+{
+    std::lock_guard<std::mutex> lock(ViewIndex::idsMutex);
+
+    auto it = ViewIndex::ids.find(id);
+    if (it == ViewIndex::ids.end())
+        return nullptr;
+
+    return &*it;
+}
+
+void ViewIndex::add(View* view)
+{
+    this->views[view->getInternedId()].push_back(view);
+}
+
+void ViewIndex::remove(View* view)
+{
+    auto it = this->views.find(view->getInternedId());
+    if (it == this->views.end())
+        return;
+
+    std::vector<View*>& views = it->second;
+    views.erase(std::remove(views.begin(), views.end(), view), views.end());
+
+    if (views.empty())
+        this->views.erase(it);
+}
+
+void ViewIndex::merge(ViewIndex* other)
+{
+    for (auto& [id, views] : other->views)
+    {
+        std::vector<View*>& ours = this->views[id];
+        ours.insert(ours.end(), views.begin(), views.end());
+    }
+
+    other->views.clear();
+}
+
+const std::vector<View*>& ViewIndex::find(const std::string* id)
+{
+    static const std::vector<View*> empty;
+
+    auto it = this->views.find(id);
+    if (it == this->views.end())
+        return empty;
+
+    return it->second;
+}
+
+} // namespace brls
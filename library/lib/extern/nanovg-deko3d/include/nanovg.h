@@ -388,6 +388,9 @@ void nvgImageSize(NVGcontext* ctx, int image, int* w, int* h);
 // Deletes created image.
 void nvgDeleteImage(NVGcontext* ctx, int image);
 
+// Returns the memory used by the font atlas textures, in bytes.
+int nvgFontAtlasMemory(NVGcontext* ctx);
+
 //
 // Paints
 //
@@ -839,6 +839,20 @@ void nvgDeleteImage(NVGcontext* ctx, int image)
 	ctx->params.renderDeleteTexture(ctx->params.userPtr, image);
 }
 
+int nvgFontAtlasMemory(NVGcontext* ctx)
+{
+	int i, w, h, size = 0;
+	for (i = 0; i < NVG_MAX_FONTIMAGES; i++) {
+		if (ctx->fontImages[i] != 0) {
+			nvgImageSize(ctx, ctx->fontImages[i], &w, &h);
+			size += w * h; // alpha textures
+		}
+	}
+	// Glyphs are rasterized in a CPU copy of the current atlas first
+	fonsGetTextureData(ctx->fs, &w, &h);
+	return size + w * h;
+}
+
 NVGpaint nvgLinearGradient(NVGcontext* ctx,
 								  float sx, float sy, float ex, float ey,
 								  NVGcolor icol, NVGcolor ocol)
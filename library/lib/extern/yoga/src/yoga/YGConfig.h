@@ -44,6 +44,8 @@ public:
   std::array<bool, facebook::yoga::enums::count<YGExperimentalFeature>()>
       experimentalFeatures = {};
   void* context = nullptr;
+  YGNodeAllocFunc allocNode = nullptr;
+  YGNodeDeallocFunc deallocNode = nullptr;
 
   YGConfig(YGLogger logger);
   void log(YGConfig*, YGNode*, YGLogLevel, void*, const char*, va_list);
@@ -217,8 +217,27 @@ YOGA_EXPORT void YGNodeMarkDirtyAndPropogateToDescendants(
 
 int32_t gConfigInstanceCount = 0;
 
+template <typename... Args>
+static YGNodeRef YGNodeAllocate(const YGConfigRef config, Args&&... args) {
+  if (config != nullptr && config->allocNode != nullptr) {
+    void* memory = config->allocNode(config, sizeof(YGNode));
+    return memory ? new (memory) YGNode(std::forward<Args>(args)...) : nullptr;
+  }
+  return new YGNode(std::forward<Args>(args)...);
+}
+
+static void YGNodeDeallocate(const YGNodeRef node) {
+  const YGConfigRef config = node->getConfig();
+  if (config != nullptr && config->deallocNode != nullptr) {
+    node->~YGNode();
+    config->deallocNode(config, node);
+    return;
+  }
+  delete node;
+}
+
 YOGA_EXPORT WIN_EXPORT YGNodeRef YGNodeNewWithConfig(const YGConfigRef config) {
-  const YGNodeRef node = new YGNode{config};
+  const YGNodeRef node = YGNodeAllocate(config, config);
   YGAssertWithConfig(
       config, node != nullptr, "Could not allocate memory for node");
   Event::publish<Event::NodeAllocation>(node, {config});
@@ -236,7 +255,7 @@ YOGA_EXPORT YGNodeRef YGNodeNew(void) {
 }
 
 YOGA_EXPORT YGNodeRef YGNodeClone(YGNodeRef oldNode) {
-  YGNodeRef node = new YGNode(*oldNode);
+  YGNodeRef node = YGNodeAllocate(oldNode->getConfig(), *oldNode);
   YGAssertWithConfig(
       oldNode->getConfig(),
       node != nullptr,
@@ -255,7 +274,7 @@ static YGConfigRef YGConfigClone(const YGConfig& oldConfig) {
 
 static YGNodeRef YGNodeDeepClone(YGNodeRef oldNode) {
   auto config = YGConfigClone(*oldNode->getConfig());
-  auto node = new YGNode{*oldNode, config};
+  auto node = YGNodeAllocate(config, *oldNode, config);
   node->setOwner(nullptr);
   Event::publish<Event::NodeAllocation>(node, {node->getConfig()});
 
@@ -286,7 +305,7 @@ YOGA_EXPORT void YGNodeFree(const YGNodeRef node) {
 
   node->clearChildren();
   Event::publish<Event::NodeDeallocation>(node, {node->getConfig()});
-  delete node;
+  YGNodeDeallocate(node);
 }
 
 static void YGConfigFreeRecursive(const YGNodeRef root) {
@@ -4405,6 +4424,14 @@ YOGA_EXPORT void YGConfigSetCloneNodeFunc(
   config->setCloneNodeCallback(callback);
 }
 
+YOGA_EXPORT void YGConfigSetNodeAllocator(
+    const YGConfigRef config,
+    const YGNodeAllocFunc alloc,
+    const YGNodeDeallocFunc dealloc) {
+  config->allocNode = alloc;
+  config->deallocNode = dealloc;
+}
+
 static void YGTraverseChildrenPreOrder(
     const YGVector& children,
     const std::function<void(YGNodeRef node)>& f) {
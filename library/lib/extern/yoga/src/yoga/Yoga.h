@@ -52,6 +52,8 @@ typedef int (*YGLogger)(
     va_list args);
 typedef YGNodeRef (
     *YGCloneNodeFunc)(YGNodeRef oldNode, YGNodeRef owner, int childIndex);
+typedef void* (*YGNodeAllocFunc)(YGConfigRef config, size_t size);
+typedef void (*YGNodeDeallocFunc)(YGConfigRef config, void* memory);
 
 // YGNode
 WIN_EXPORT YGNodeRef YGNodeNew(void);
@@ -345,6 +347,14 @@ WIN_EXPORT void YGConfigSetCloneNodeFunc(
     YGConfigRef config,
     YGCloneNodeFunc callback);
 
+// Allocates the memory of the nodes created with the config (and their
+// clones) with the given functions instead of new and delete. Both must be
+// set, before any node is created with the config.
+WIN_EXPORT void YGConfigSetNodeAllocator(
+    YGConfigRef config,
+    YGNodeAllocFunc alloc,
+    YGNodeDeallocFunc dealloc);
+
 // Export only for C#
 WIN_EXPORT YGConfigRef YGConfigGetDefault(void);
 
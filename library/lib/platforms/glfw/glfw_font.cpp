@@ -28,6 +28,17 @@
 namespace brls
 {
 
+void GLFWFontLoader::preloadFonts()
+{
+    if (access(USER_REGULAR_PATH.c_str(), F_OK) != -1)
+        this->preloadFontFile(USER_REGULAR_PATH);
+    else
+        this->preloadFontFile(INTER_FONT_PATH);
+
+    this->preloadFontFile(USER_SWITCH_ICONS_PATH);
+    this->preloadMaterialFromResources();
+}
+
 void GLFWFontLoader::loadFonts()
 {
     // Regular
@@ -127,6 +127,27 @@ void GLFWVideoContext::resetState()
     glDisable(GL_STENCIL_TEST);
 }
 
+void GLFWVideoContext::setVSync(bool enabled)
+{
+    glfwSwapInterval(enabled ? 1 : 0);
+}
+
+float GLFWVideoContext::getDisplayRefreshRate()
+{
+    GLFWmonitor* monitor = glfwGetWindowMonitor(this->window);
+
+    // Windowed mode: assume the window is on the primary monitor
+    if (!monitor)
+        monitor = glfwGetPrimaryMonitor();
+
+    const GLFWvidmode* mode = monitor ? glfwGetVideoMode(monitor) : nullptr;
+
+    if (!mode || mode->refreshRate <= 0)
+        return 60.0f;
+
+    return (float)mode->refreshRate;
+}
+
 GLFWVideoContext::~GLFWVideoContext()
 {
     if (this->nvgContext)
@@ -0,0 +1,41 @@
+/*
+    Copyright 2021 natinusala
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+#include <borealis/core/assets.hpp>
+#include <borealis/platforms/headless/headless_font.hpp>
+
+#define INTER_FONT_PATH BRLS_ASSET("inter/Inter-Switch.ttf")
+
+namespace brls
+{
+
+void HeadlessFontLoader::preloadFonts()
+{
+    this->preloadFontFile(INTER_FONT_PATH);
+    this->preloadMaterialFromResources();
+}
+
+void HeadlessFontLoader::loadFonts()
+{
+    // Regular
+    this->loadFontFromFile(FONT_REGULAR, INTER_FONT_PATH);
+
+    // Material icons
+    this->loadMaterialFromResources();
+}
+
+} // namespace brls
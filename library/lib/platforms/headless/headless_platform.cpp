@@ -0,0 +1,84 @@
+/*
+    Copyright 2021 natinusala
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+#include <borealis/core/i18n.hpp>
+#include <borealis/platforms/headless/headless_platform.hpp>
+
+namespace brls
+{
+
+HeadlessPlatform::HeadlessPlatform()
+{
+    this->fontLoader   = new HeadlessFontLoader();
+    this->audioPlayer  = new NullAudioPlayer();
+    this->inputManager = new HeadlessInputManager();
+}
+
+void HeadlessPlatform::createWindow(std::string windowTitle, uint32_t windowWidth, uint32_t windowHeight)
+{
+    this->videoContext = new HeadlessVideoContext(windowWidth, windowHeight);
+}
+
+std::string HeadlessPlatform::getName()
+{
+    return "Headless";
+}
+
+bool HeadlessPlatform::mainLoopIteration()
+{
+    return true;
+}
+
+AudioPlayer* HeadlessPlatform::getAudioPlayer()
+{
+    return this->audioPlayer;
+}
+
+VideoContext* HeadlessPlatform::getVideoContext()
+{
+    return this->videoContext;
+}
+
+InputManager* HeadlessPlatform::getInputManager()
+{
+    return this->inputManager;
+}
+
+FontLoader* HeadlessPlatform::getFontLoader()
+{
+    return this->fontLoader;
+}
+
+ThemeVariant HeadlessPlatform::getThemeVariant()
+{
+    return ThemeVariant::LIGHT;
+}
+
+std::string HeadlessPlatform::getLocale()
+{
+    return LOCALE_DEFAULT;
+}
+
+HeadlessPlatform::~HeadlessPlatform()
+{
+    delete this->audioPlayer;
+    delete this->videoContext;
+    delete this->inputManager;
+    delete this->fontLoader;
+}
+
+} // namespace brls
@@ -0,0 +1,158 @@
+/*
+    Copyright 2021 natinusala
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+#include <borealis/core/application.hpp>
+#include <borealis/core/logger.hpp>
+#include <borealis/platforms/headless/headless_video.hpp>
+
+namespace brls
+{
+
+static int headlessRenderCreate(void* context)
+{
+    return 1;
+}
+
+static int headlessUpdateTexture(void* context, int texture, int x, int y, int width, int height, const unsigned char* data)
+{
+    return 1;
+}
+
+static void headlessViewport(void* context, float width, float height, float devicePixelRatio)
+{
+}
+
+static void headlessCancel(void* context)
+{
+}
+
+static void headlessFlush(void* context)
+{
+}
+
+static void headlessFill(void* context, NVGpaint* paint, NVGcompositeOperationState compositeOperation, NVGscissor* scissor, float fringe, const float* bounds, const NVGpath* paths, int pathsCount)
+{
+}
+
+static void headlessStroke(void* context, NVGpaint* paint, NVGcompositeOperationState compositeOperation, NVGscissor* scissor, float fringe, float strokeWidth, const NVGpath* paths, int pathsCount)
+{
+}
+
+static void headlessTriangles(void* context, NVGpaint* paint, NVGcompositeOperationState compositeOperation, NVGscissor* scissor, const NVGvertex* vertices, int verticesCount)
+{
+}
+
+static void headlessRenderDelete(void* context)
+{
+}
+
+int HeadlessVideoContext::createTexture(void* context, int type, int width, int height, int flags, const unsigned char* data)
+{
+    HeadlessVideoContext* self = (HeadlessVideoContext*)context;
+
+    int texture             = self->nextTexture++;
+    self->textures[texture] = { width, height };
+
+    return texture;
+}
+
+int HeadlessVideoContext::deleteTexture(void* context, int texture)
+{
+    HeadlessVideoContext* self = (HeadlessVideoContext*)context;
+    return self->textures.erase(texture) > 0;
+}
+
+int HeadlessVideoContext::getTextureSize(void* context, int texture, int* width, int* height)
+{
+    HeadlessVideoContext* self = (HeadlessVideoContext*)context;
+
+    auto it = self->textures.find(texture);
+    if (it == self->textures.end())
+        return 0;
+
+    *width  = it->second.width;
+    *height = it->second.height;
+    return 1;
+}
+
+HeadlessVideoContext::HeadlessVideoContext(uint32_t windowWidth, uint32_t windowHeight)
+{
+    NVGparams params = {};
+
+    params.userPtr              = this;
+    params.edgeAntiAlias        = 1;
+    params.renderCreate         = headlessRenderCreate;
+    params.renderCreateTexture  = HeadlessVideoContext::createTexture;
+    params.renderDeleteTexture  = HeadlessVideoContext::deleteTexture;
+    params.renderUpdateTexture  = headlessUpdateTexture;
+    params.renderGetTextureSize = HeadlessVideoContext::getTextureSize;
+    params.renderViewport       = headlessViewport;
+    params.renderCancel         = headlessCancel;
+    params.renderFlush          = headlessFlush;
+    params.renderFill           = headlessFill;
+    params.renderStroke         = headlessStroke;
+    params.renderTriangles      = headlessTriangles;
+    params.renderDelete         = headlessRenderDelete;
+
+    this->nvgContext = nvgCreateInternal(&params);
+    if (!this->nvgContext)
+    {
+        Logger::error("headless: unable to init nanovg");
+        return;
+    }
+
+    // Setup scaling
+    Application::onWindowResized(windowWidth, windowHeight);
+}
+
+void HeadlessVideoContext::beginFrame()
+{
+}
+
+void HeadlessVideoContext::endFrame()
+{
+}
+
+void HeadlessVideoContext::clear(NVGcolor color)
+{
+}
+
+void HeadlessVideoContext::resetState()
+{
+}
+
+void HeadlessVideoContext::setVSync(bool enabled)
+{
+}
+
+float HeadlessVideoContext::getDisplayRefreshRate()
+{
+    return 60.0f;
+}
+
+HeadlessVideoContext::~HeadlessVideoContext()
+{
+    if (this->nvgContext)
+        nvgDeleteInternal(this->nvgContext);
+}
+
+NVGcontext* HeadlessVideoContext::getNVGContext()
+{
+    return this->nvgContext;
+}
+
+} // namespace brls
@@ -24,6 +24,12 @@
 namespace brls
 {
 
+void SwitchFontLoader::preloadFonts()
+{
+    // Shared fonts are already in memory, only read the Material icons from romfs
+    this->preloadMaterialFromResources();
+}
+
 void SwitchFontLoader::loadFonts()
 {
     PlFontData font;
@@ -116,6 +116,7 @@ void SwitchVideoContext::createFramebufferResources()
 
     // Create the swapchain using the framebuffers
     this->swapchain = dk::SwapchainMaker { this->device, nwindowGetDefault(), fbArray }.create();
+    this->swapchain.setSwapInterval(this->vsync ? 1 : 0);
 
     // Generate the main rendering cmdlist
     this->recordStaticCommands();
@@ -224,6 +225,20 @@ void SwitchVideoContext::endFrame()
     queue.presentImage(this->swapchain, this->imageSlot);
 }
 
+void SwitchVideoContext::setVSync(bool enabled)
+{
+    this->vsync = enabled;
+
+    if (this->swapchain)
+        this->swapchain.setSwapInterval(enabled ? 1 : 0);
+}
+
+float SwitchVideoContext::getDisplayRefreshRate()
+{
+    // The console always outputs at 60Hz, docked or handheld
+    return 60.0f;
+}
+
 void SwitchVideoContext::destroyFramebufferResources()
 {
     // Return early if we have nothing to destroy
@@ -17,7 +17,9 @@
 
 #include <borealis/views/hint.hpp>
 #include <borealis/core/application.hpp>
+#include <borealis/core/async.hpp>
 #include <borealis/core/input.hpp>
+#include <borealis/core/trace.hpp>
 #include <string>
 #include <set>
 
@@ -102,19 +104,26 @@ Hint::Hint()
 {
     this->inflateFromXMLString(hintXML);
 
-    this->globalFocusEventSubscriptor = Application::getGlobalFocusChangeEvent()->subscribe([this](View* newFocus) {
-        this->rebuildHints();
+    this->globalFocusEventSubscription = Application::getGlobalFocusChangeEvent()->subscribeScoped([this](View* newFocus) {
+        this->scheduleRebuild();
     });
 
-    this->globalHintsUpdateEventSubscriptor = Application::getGlobalHintsUpdateEvent()->subscribe([this]() {
-        this->rebuildHints();
+    this->globalHintsUpdateEventSubscription = Application::getGlobalHintsUpdateEvent()->subscribeScoped([this]() {
+        this->scheduleRebuild();
     });
 }
 
-Hint::~Hint()
+void Hint::scheduleRebuild()
 {
-    Application::getGlobalFocusChangeEvent()->unsubscribe(this->globalFocusEventSubscriptor);
-    Application::getGlobalHintsUpdateEvent()->unsubscribe(this->globalHintsUpdateEventSubscriptor);
+    if (this->rebuildScheduled)
+        return;
+
+    this->rebuildScheduled = true;
+
+    brls::sync(this->getLifetimeToken(), [this]() {
+        this->rebuildScheduled = false;
+        this->rebuildHints();
+    });
 }
 
 View *Hint::create()
@@ -124,6 +133,8 @@ View *Hint::create()
 
 void Hint::rebuildHints()
 {
+    BRLS_TRACE_SCOPE("rebuildHints");
+
     {
         View* focusParent    = Application::getCurrentFocus();
         View* hintBaseParent = this;
@@ -146,9 +157,6 @@ void Hint::rebuildHints()
             return;
     }
 
-    for (auto view : this->getChildren())
-        this->removeView(view);
-        
     std::set<ControllerButton> addedButtons;
     View* focusParent = Application::getCurrentFocus();
 
@@ -173,15 +181,32 @@ void Hint::rebuildHints()
 
     std::stable_sort(actions.begin(), actions.end(), actionsSortFunc);
 
-    for (Action action : actions)
+    // Reuse the labels already there, only changing the text if needed
+    for (size_t i = 0; i < actions.size(); i++)
     {
-        std::string hintTxt = getKeyIcon(action.button) + "  " + action.hintText;
+        std::string hintTxt = getKeyIcon(actions[i].button) + "  " + actions[i].hintText;
+
+        if (i < this->labels.size())
+        {
+            if (this->labels[i]->getFullText() != hintTxt)
+                this->labels[i]->setText(hintTxt);
+
+            continue;
+        }
 
         Label *label = new Label();
         label->setFontSize(22.0f);
         label->setText(hintTxt);
         label->setMarginRight(30.0f);
         this->addView(label);
+        this->labels.push_back(label);
+    }
+
+    // Remove the extra ones
+    while (this->labels.size() > actions.size())
+    {
+        this->removeView(this->labels.back());
+        this->labels.pop_back();
     }
 }
 
@@ -17,8 +17,11 @@
 */
 
 #include <borealis/core/application.hpp>
+#include <borealis/core/image_decoder.hpp>
+#include <borealis/core/trace.hpp>
 #include <borealis/core/util.hpp>
 #include <borealis/views/image.hpp>
+#include <cmath>
 
 namespace brls
 {
@@ -60,7 +63,6 @@ static float measureHeight(YGNodeRef node, float width, YGMeasureMode widthMode,
 static YGSize imageMeasureFunc(YGNodeRef node, float width, YGMeasureMode widthMode, float height, YGMeasureMode heightMode)
 {
     Image* image                 = (Image*)node->getContext();
-    int texture                  = image->getTexture();
     float originalWidth          = image->getOriginalImageWidth();
     float originalHeight         = image->getOriginalImageHeight();
     ImageScalingType scalingType = image->getScalingType();
@@ -70,7 +72,8 @@ static YGSize imageMeasureFunc(YGNodeRef node, float width, YGMeasureMode widthM
         .height = height,
     };
 
-    if (texture == 0)
+    // Images decoded after the layout already know their size
+    if (originalWidth <= 0 || originalHeight <= 0)
         return size;
 
     // Stretched mode: we don't care about the size of the image
@@ -135,6 +138,22 @@ Image::Image()
             { "nearest", ImageInterpolation::NEAREST },
         });
 
+    this->registerStringXMLAttribute("atlas", [this](std::string value) {
+        this->setAtlasGroup(value);
+    });
+
+    this->registerAutoXMLAttribute("maxDecodeSize", [this] {
+        this->setMaxDecodeSize(View::AUTO);
+    });
+
+    this->registerFloatXMLAttribute("maxDecodeSize", [this](float value) {
+        this->setMaxDecodeSize(value);
+    });
+
+    this->registerBoolXMLAttribute("mipmaps", [this](bool value) {
+        this->setMipmapsEnabled(value);
+    });
+
     this->registerFilePathXMLAttribute("image", [this](std::string value) {
         this->setImageFromFile(value);
     });
@@ -154,8 +173,16 @@ void Image::draw(NVGcontext* vg, float x, float y, float width, float height, St
     float coordX = x + this->imageX;
     float coordY = y + this->imageY;
 
-    this->paint.xform[4] = coordX;
-    this->paint.xform[5] = coordY;
+    // Packed images can move in their page, get their position every frame
+    if (this->atlasImage)
+    {
+        this->paint = this->atlasImage->getPaint(vg, coordX, coordY, this->imageWidth, this->imageHeight, 1.0f);
+    }
+    else
+    {
+        this->paint.xform[4] = coordX;
+        this->paint.xform[5] = coordY;
+    }
 
     nvgBeginPath(vg);
     nvgRect(vg, coordX, coordY, this->imageWidth, this->imageHeight);
@@ -169,6 +196,29 @@ void Image::draw(NVGcontext* vg, float x, float y, float width, float height, St
 void Image::onLayout()
 {
     this->invalidateImageBounds();
+
+    if (std::isnan(this->maxDecodeSize))
+        this->updateDecodeSize();
+}
+
+void Image::updateDecodeSize()
+{
+    if (this->imagePath.empty() || this->atlasImage || this->imageWidth <= 0 || this->imageHeight <= 0)
+        return;
+
+    // Smallest scale that still gives one texel per pixel on screen
+    float scale  = Application::windowScale;
+    float needed = std::min(1.0f, std::max(this->imageWidth * scale / this->originalImageWidth, this->imageHeight * scale / this->originalImageHeight));
+
+    // Only decode again if the texture is too small, or way too big, to not do it
+    // for every small change of size
+    float current = (float)this->decodedWidth / this->originalImageWidth;
+
+    if (this->texture != 0 && current >= needed * 0.99f && current <= needed * 2.0f)
+        return;
+
+    this->decodeImage((int)ceilf(this->originalImageWidth * needed), (int)ceilf(this->originalImageHeight * needed));
+    this->invalidateImageBounds();
 }
 
 void Image::setImageAlign(ImageAlignment align)
@@ -179,7 +229,7 @@ void Image::setImageAlign(ImageAlignment align)
 
 void Image::invalidateImageBounds()
 {
-    if (this->texture == 0)
+    if (this->originalImageWidth <= 0 || this->originalImageHeight <= 0)
         return;
 
     float width  = this->getWidth();
@@ -235,8 +285,11 @@ void Image::invalidateImageBounds()
     }
 
     // Create the paint - actual X and Y positions are updated every frame in draw() to apply translation (scrolling...)
-    NVGcontext* vg = Application::getNVGContext();
-    this->paint    = nvgImagePattern(vg, 0, 0, this->imageWidth, this->imageHeight, 0, this->texture, 1.0f);
+    if (!this->atlasImage && this->texture != 0)
+    {
+        NVGcontext* vg = Application::getNVGContext();
+        this->paint    = nvgImagePattern(vg, 0, 0, this->imageWidth, this->imageHeight, 0, this->texture, 1.0f);
+    }
 }
 
 void Image::setImageFromRes(std::string name)
@@ -251,22 +304,129 @@ void Image::setInterpolation(ImageInterpolation interpolation)
 
 int Image::getImageFlags()
 {
+    int flags = 0;
+
     if (this->interpolation == ImageInterpolation::NEAREST)
-        return NVG_IMAGE_NEAREST;
+        flags |= NVG_IMAGE_NEAREST;
+
+    if (this->mipmaps)
+        flags |= NVG_IMAGE_GENERATE_MIPMAPS;
 
-    return 0;
+    return flags;
 }
 
-void Image::setImageFromFile(std::string path)
+void Image::setAtlasGroup(std::string group)
+{
+    this->atlasGroup = group;
+}
+
+void Image::setMaxDecodeSize(float size)
+{
+    this->maxDecodeSize = size;
+}
+
+void Image::setMipmapsEnabled(bool enabled)
+{
+    this->mipmaps = enabled;
+}
+
+void Image::freeImage()
 {
     NVGcontext* vg = Application::getNVGContext();
 
-    // Free the old texture if necessary
+    if (this->atlasImage)
+        ImageAtlas::release(vg, this->atlasImage);
+    else if (this->texture != 0)
+        nvgDeleteImage(vg, this->texture);
+
+    this->atlasImage    = nullptr;
+    this->texture       = 0;
+    this->decodedWidth  = 0;
+    this->decodedHeight = 0;
+}
+
+void Image::decodeImage(int maxWidth, int maxHeight)
+{
+    BRLS_TRACE_SCOPE("decodeImage");
+
+    DecodedImage image;
+
+    if (!ImageDecoder::decode(this->imagePath, maxWidth, maxHeight, &image))
+        fatal("Cannot load image from file \"" + this->imagePath + "\"");
+
+    NVGcontext* vg = Application::getNVGContext();
+    int texture    = nvgCreateImageRGBA(vg, image.width, image.height, this->getImageFlags() | NVG_IMAGE_PREMULTIPLIED, image.pixels.data());
+
+    if (texture == 0)
+        fatal("Cannot create texture for image \"" + this->imagePath + "\"");
+
     if (this->texture != 0)
         nvgDeleteImage(vg, this->texture);
 
+    this->texture       = texture;
+    this->decodedWidth  = image.width;
+    this->decodedHeight = image.height;
+
+    // The layout uses the size of the file, not the one of the texture
+    this->originalImageWidth  = (float)image.sourceWidth;
+    this->originalImageHeight = (float)image.sourceHeight;
+
+    BRLS_LOG_DEBUG("Decoded image \"{}\" at {}x{} (source is {}x{})", this->imagePath, image.width, image.height, image.sourceWidth, image.sourceHeight);
+}
+
+void Image::setImageFromFile(std::string path)
+{
+    BRLS_TRACE_SCOPE("loadImage");
+
+    NVGcontext* vg = Application::getNVGContext();
+
+    // Free the old texture if necessary
+    this->freeImage();
+
+    this->imagePath = path;
+
+    int flags = this->getImageFlags();
+
+    // Try to pack it in an atlas first (mipmaps would bleed over the other images of the page)
+    if (this->atlasGroup != "none" && !this->mipmaps)
+        this->atlasImage = ImageAtlas::load(vg, path, this->atlasGroup, flags);
+
+    if (this->atlasImage)
+    {
+        this->texture             = this->atlasImage->texture;
+        this->originalImageWidth  = (float)this->atlasImage->width;
+        this->originalImageHeight = (float)this->atlasImage->height;
+
+        this->invalidate();
+        return;
+    }
+
+    // Downscaled texture, sized from the layout: only read the size for now,
+    // the image is decoded once the view is laid out
+    if (std::isnan(this->maxDecodeSize))
+    {
+        int width, height;
+        if (!ImageDecoder::getSize(path, &width, &height))
+            fatal("Cannot load image from file \"" + path + "\"");
+
+        this->originalImageWidth  = (float)width;
+        this->originalImageHeight = (float)height;
+
+        this->invalidate();
+        return;
+    }
+
+    // Downscaled texture, with a given size
+    if (this->maxDecodeSize > 0)
+    {
+        int size = (int)ceilf(this->maxDecodeSize * Application::windowScale);
+        this->decodeImage(size, size);
+
+        this->invalidate();
+        return;
+    }
+
     // Load the new texture
-    int flags     = this->getImageFlags();
     this->texture = nvgCreateImage(vg, path.c_str(), flags);
 
     if (this->texture == 0)
@@ -302,6 +462,23 @@ int Image::getTexture()
     return this->texture;
 }
 
+size_t Image::getTextureSize()
+{
+    if (this->texture == 0 || this->atlasImage)
+        return 0;
+
+    int width, height;
+    nvgImageSize(Application::getNVGContext(), this->texture, &width, &height);
+
+    size_t size = (size_t)width * height * 4;
+
+    // The mipmaps chain takes a third more
+    if (this->mipmaps)
+        size += size / 3;
+
+    return size;
+}
+
 float Image::getOriginalImageHeight()
 {
     return this->originalImageHeight;
@@ -309,10 +486,7 @@ float Image::getOriginalImageHeight()
 
 Image::~Image()
 {
-    NVGcontext* vg = Application::getNVGContext();
-
-    if (this->texture != 0)
-        nvgDeleteImage(vg, this->texture);
+    this->freeImage();
 }
 
 View* Image::create()
@@ -62,6 +62,38 @@ void ScrollingFrame::removeView(View* view)
     this->setContentView(nullptr);
 }
 
+void ScrollingFrame::addViews(const std::vector<View*>& views, size_t position)
+{
+    if (views.size() > 1)
+        fatal("ScrollingFrame can only have one content view");
+
+    if (!views.empty())
+        this->setContentView(views[0]);
+}
+
+void ScrollingFrame::removeViewsRange(size_t start, size_t count)
+{
+    // The content view is the only child
+    if (start == 0 && count > 0)
+        this->setContentView(nullptr);
+}
+
+void ScrollingFrame::removeAllViews()
+{
+    this->setContentView(nullptr);
+}
+
+bool ScrollingFrame::detachView(View* view)
+{
+    if (!view || view != this->contentView)
+        return false;
+
+    Box::detachView(view);
+    this->contentView = nullptr;
+
+    return true;
+}
+
 void ScrollingFrame::setContentView(View* view)
 {
     if (this->contentView)
@@ -181,7 +181,7 @@ void Sidebar::addItem(std::string label, GenericEvent::Callback focusCallback)
     SidebarItem* item = new SidebarItem();
     item->setGroup(&this->group);
     item->setLabel(label);
-    item->getActiveEvent()->subscribe(focusCallback);
+    item->getActiveEvent()->subscribe(std::move(focusCallback));
 
     this->contentBox->addView(item);
 }
@@ -0,0 +1,255 @@
+#!/usr/bin/env python3
+"""
+Compiles the i18n XML files of every locale into one binary catalog per locale,
+loaded as-is (memory-mapped) by borealis at runtime.
+
+Usage: i18n-compile.py <i18n directory> [output directory] [--stamp <file>]
+
+The output directory defaults to the i18n directory, the catalogs are named
+"<locale>.brlsi18n". Stray files and directories are reported as warnings,
+invalid XML files are errors. Translations using different format placeholders
+than the default locale (for brls::getStr()) are errors too.
+
+Catalog format (little-endian), must be kept in sync with i18n.cpp:
+    header:  magic "BRLSI18N", version (u32), count (u32), strings offset (u32), strings size (u32)
+    entries: count times { key hash (u64), key offset (u32), key length (u32), value offset (u32), value length (u32) }
+             sorted by hash then key, hashes are 64-bit FNV-1a of the key
+    strings: keys and values, each followed by a NUL character
+"""
+
+import os
+import re
+import struct
+import sys
+import xml.etree.ElementTree
+import xml.parsers.expat
+
+MAGIC   = b"BRLSI18N"
+VERSION = 1
+
+LOCALES = [
+    "ja", "en-US", "en-GB", "fr", "fr-CA", "de", "it", "es", "zh-CN", "zh-Hans", "zh-Hant", "zh-TW",
+    "ko", "nl", "pt", "pt-BR", "ru", "es-419",
+]
+
+DEFAULT_LOCALE = "en-US"
+
+CATALOG_EXTENSION = ".brlsi18n"
+
+errors = 0
+
+def warning(message):
+    print(f"warning: {message}", file=sys.stderr)
+
+def error(message):
+    global errors
+    errors += 1
+    print(f"error: {message}", file=sys.stderr)
+
+PLACEHOLDER = re.compile(r"\{\{|\}\}|\{([^{}]*)\}")
+
+def getPlaceholders(string):
+    """Returns the sorted list of arguments used by the format string, or None if it's not a valid one."""
+    placeholders = []
+    automatic    = 0
+
+    for match in PLACEHOLDER.finditer(string):
+        if match.group(1) is None:
+            continue # escaped brace
+
+        argument = match.group(1).split(":", 1)[0].split("!", 1)[0]
+
+        if argument == "":
+            argument = str(automatic)
+            automatic += 1
+
+        placeholders.append(argument)
+
+    return sorted(set(placeholders))
+
+def checkPlaceholders(locale, strings, defaultStrings):
+    for key, value in strings.items():
+        if key not in defaultStrings:
+            warning(f"string {key} of locale {locale} does not exist in the default locale {DEFAULT_LOCALE}")
+            continue
+
+        expected = getPlaceholders(defaultStrings[key])
+        actual   = getPlaceholders(value)
+
+        if expected != actual:
+            error(f"string {key} of locale {locale} uses placeholders {actual} but the default locale {DEFAULT_LOCALE} uses {expected}")
+
+def fnv1a(data: bytes) -> int:
+    h = 0xCBF29CE484222325
+    for byte in data:
+        h ^= byte
+        h = (h * 0x100000001B3) & 0xFFFFFFFFFFFFFFFF
+    return h
+
+def parseXML(path):
+    # Expat without namespaces support, since the "brls:" prefix is never declared
+    builder = xml.etree.ElementTree.TreeBuilder()
+    parser  = xml.parsers.expat.ParserCreate()
+
+    parser.StartElementHandler  = lambda tag, attributes: builder.start(tag, attributes)
+    parser.EndElementHandler    = builder.end
+    parser.CharacterDataHandler = builder.data
+
+    with open(path, "rb") as f:
+        parser.ParseFile(f)
+
+    return builder.close()
+
+def getStrings(element, path, strings, file):
+    for child in element:
+        name = child.get("name")
+        if not name:
+            warning(f"{file}: element {child.tag} without a name, ignoring it")
+            continue
+
+        childPath = f"{path}/{name}"
+
+        if child.tag == "brls:List":
+            getStrings(child, childPath, strings, file)
+        elif child.tag == "brls:String":
+            text = child.text or ""
+
+            if childPath in strings:
+                warning(f"{file}: duplicate string {childPath}")
+
+            strings[childPath] = text
+        else:
+            warning(f"{file}: unknown element {child.tag}, ignoring it")
+
+def compileLocale(directory):
+    strings = {}
+
+    for name in sorted(os.listdir(directory)):
+        path = os.path.join(directory, name)
+
+        if os.path.isdir(path):
+            warning(f"stray directory {path} in locale directory")
+            continue
+
+        if not name.endswith(".xml"):
+            warning(f"stray file {path} without extension .xml")
+            continue
+
+        try:
+            root = parseXML(path)
+        except Exception as e:
+            if os.path.getsize(path) == 0:
+                warning(f"stray XML file {path}: empty XML document")
+            else:
+                error(f"cannot parse {path}: {e}")
+            continue
+
+        if root.tag != "brls:i18nDoc":
+            warning(f"stray XML file {path}: root element is {root.tag}")
+            continue
+
+        getStrings(root, os.path.splitext(name)[0], strings, path)
+
+    return strings
+
+def writeCatalog(strings, path):
+    entries = []
+    blob    = bytearray()
+
+    for key, value in strings.items():
+        keyBytes   = key.encode("utf-8")
+        valueBytes = value.encode("utf-8")
+
+        keyOffset = len(blob)
+        blob += keyBytes + b"\0"
+
+        valueOffset = len(blob)
+        blob += valueBytes + b"\0"
+
+        entries.append((fnv1a(keyBytes), keyBytes, keyOffset, len(keyBytes), valueOffset, len(valueBytes)))
+
+    entries.sort(key=lambda entry: (entry[0], entry[1]))
+
+    headerSize     = 8 + 4 * 4
+    stringsOffset  = headerSize + len(entries) * 24
+
+    content = bytearray()
+    content += MAGIC
+    content += struct.pack("<IIII", VERSION, len(entries), stringsOffset, len(blob))
+
+    for (h, _, keyOffset, keyLength, valueOffset, valueLength) in entries:
+        content += struct.pack("<QIIII", h, keyOffset, keyLength, valueOffset, valueLength)
+
+    content += blob
+
+    # Don't touch the file if nothing changed, to avoid needless rebuilds
+    if os.path.exists(path):
+        with open(path, "rb") as f:
+            if f.read() == content:
+                return
+
+    with open(path + ".tmp", "wb") as f:
+        f.write(content)
+
+    os.replace(path + ".tmp", path)
+
+def main():
+    arguments = [argument for argument in sys.argv[1:]]
+    stamp     = None
+
+    if "--stamp" in arguments:
+        index = arguments.index("--stamp")
+        stamp = arguments[index + 1]
+        del arguments[index:index + 2]
+
+    if len(arguments) < 1:
+        print(__doc__, file=sys.stderr)
+        return 1
+
+    i18nDirectory   = arguments[0]
+    outputDirectory = arguments[1] if len(arguments) > 1 else i18nDirectory
+
+    if not os.path.isdir(i18nDirectory):
+        error(f"{i18nDirectory} is not a directory")
+        return 1
+
+    if not os.path.isdir(os.path.join(i18nDirectory, DEFAULT_LOCALE)):
+        warning(f"no default locale directory {os.path.join(i18nDirectory, DEFAULT_LOCALE)}")
+
+    os.makedirs(outputDirectory, exist_ok=True)
+
+    # Default locale first, to check the others against it
+    defaultStrings = {}
+    if os.path.isdir(os.path.join(i18nDirectory, DEFAULT_LOCALE)):
+        defaultStrings = compileLocale(os.path.join(i18nDirectory, DEFAULT_LOCALE))
+
+    for name in sorted(os.listdir(i18nDirectory)):
+        path = os.path.join(i18nDirectory, name)
+
+        if not os.path.isdir(path):
+            if not name.endswith(CATALOG_EXTENSION):
+                warning(f"stray file {path} in i18n directory")
+            continue
+
+        if name not in LOCALES:
+            warning(f"stray directory {path} does not match any locale")
+            continue
+
+        strings = defaultStrings if name == DEFAULT_LOCALE else compileLocale(path)
+
+        if name != DEFAULT_LOCALE:
+            checkPlaceholders(name, strings, defaultStrings)
+
+        writeCatalog(strings, os.path.join(outputDirectory, name + CATALOG_EXTENSION))
+
+    if errors > 0:
+        return 1
+
+    if stamp:
+        with open(stamp, "w") as f:
+            f.write("")
+
+    return 0
+
+if __name__ == "__main__":
+    sys.exit(main())